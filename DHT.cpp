@@ -25,9 +25,8 @@
 
 #include "DHT.h"
 
-#define MIN_INTERVAL 2000 /**< min interval value */
-#define TIMEOUT                                      \
-  UINT32_MAX /**< Used programmatically for timeout. \
+#define TIMEOUT                                             \
+  DHT_PULSE_TIMEOUT /**< Used programmatically for timeout. \
                    Not a timeout duration. Type: uint32_t. */
 
 /*!
@@ -43,13 +42,14 @@ DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
   (void)count; // Workaround to avoid compiler warning.
   _pin = pin;
   _type = type;
+  _correct = false;
+  _lastresult = false;
+  _lastcorrected = false;
+  _corrections = 0;
 #ifdef __AVR
   _bit = digitalPinToBitMask(pin);
   _port = digitalPinToPort(pin);
 #endif
-  _maxcycles =
-      microsecondsToClockCycles(1000); // 1 millisecond timeout for
-                                       // reading pulses from DHT sensor.
   // Note that count is now ignored as the DHT reading algorithm adjusts itself
   // based on the speed of the processor.
 }
@@ -64,11 +64,11 @@ void DHT::begin(uint8_t usec) {
   // set up the pins!
   pinMode(_pin, INPUT_PULLUP);
   // Using this value makes sure that millis() - lastreadtime will be
-  // >= MIN_INTERVAL right away. Note that this assignment wraps around,
-  // but so will the subtraction.
-  _lastreadtime = millis() - MIN_INTERVAL;
+  // >= DHT_MIN_INTERVAL right away. Note that this assignment wraps
+  // around, but so will the subtraction.
+  _lastreadtime = millis() - DHT_MIN_INTERVAL;
   DEBUG_PRINT("DHT max clock cycles: ");
-  DEBUG_PRINTLN(_maxcycles, DEC);
+  DEBUG_PRINTLN(microsecondsToClockCycles(1000), DEC);
   pullTime = usec;
 }
 
@@ -86,38 +86,9 @@ float DHT::readTemperature(bool S, bool force) {
   float f = NAN;
 
   if (read(force)) {
-    switch (_type) {
-      case DHT11:
-        f = data[2];
-        if (data[3] & 0x80) {
-          f = -1 - f;
-        }
-        f += (data[3] & 0x0f) * 0.1;
-        if (S) {
-          f = convertCtoF(f);
-        }
-        break;
-      case DHT12:
-        f = data[2];
-        f += (data[3] & 0x0f) * 0.1;
-        if (data[2] & 0x80) {
-          f *= -1;
-        }
-        if (S) {
-          f = convertCtoF(f);
-        }
-        break;
-      case DHT22:
-      case DHT21:
-        f = ((word)(data[2] & 0x7F)) << 8 | data[3];
-        f *= 0.1;
-        if (data[2] & 0x80) {
-          f *= -1;
-        }
-        if (S) {
-          f = convertCtoF(f);
-        }
-        break;
+    f = dhtFrameTemperature(_type, data);
+    if (S) {
+      f = convertCtoF(f);
     }
   }
   return f;
@@ -152,17 +123,7 @@ float DHT::convertFtoC(float f) {
 float DHT::readHumidity(bool force) {
   float f = NAN;
   if (read(force)) {
-    switch (_type) {
-      case DHT11:
-      case DHT12:
-        f = data[0] + data[1] * 0.1;
-        break;
-      case DHT22:
-      case DHT21:
-        f = ((word)data[0]) << 8 | data[1];
-        f *= 0.1;
-        break;
-    }
+    f = dhtFrameHumidity(_type, data);
   }
   return f;
 }
@@ -236,13 +197,15 @@ bool DHT::read(bool force) {
   // Check if sensor was read less than two seconds ago and return early
   // to use last reading.
   uint32_t currenttime = millis();
-  if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
+  if (!force && ((currenttime - _lastreadtime) < DHT_MIN_INTERVAL)) {
     return _lastresult; // return last correct measurement
   }
   _lastreadtime = currenttime;
 
   // Reset 40 bits of received data to zero.
   data[0] = data[1] = data[2] = data[3] = data[4] = 0;
+  _lastresult = false;
+  _lastcorrected = false;
 
 #if defined(ESP8266)
   yield(); // Handle WiFi / reset software watchdog
@@ -256,80 +219,22 @@ bool DHT::read(bool force) {
   pinMode(_pin, INPUT_PULLUP);
   delay(1);
 
-  // First set data line low for a period according to sensor type
-  pinMode(_pin, OUTPUT);
-  digitalWrite(_pin, LOW);
-  switch (_type) {
-    case DHT22:
-    case DHT21:
-      delayMicroseconds(1100); // data sheet says "at least 1ms"
-      break;
-    case DHT11:
-    default:
-      delay(20); // data sheet says at least 18ms, 20ms just to be safe
-      break;
-  }
+  // First set data line low for a period according to sensor type.
+  startSignal(dhtStartPulse(_type));
 
   uint32_t cycles[80];
-  {
-    // End the start signal by setting data line high for 40 microseconds.
-    pinMode(_pin, INPUT_PULLUP);
-
-    // Delay a moment to let sensor pull data line low.
-    delayMicroseconds(pullTime);
-
-    // Now start reading the data line to get the value from the DHT sensor.
-
-    // Turn off interrupts temporarily because the next sections
-    // are timing critical and we don't want any interruptions.
-    InterruptLock lock;
-
-    // First expect a low signal for ~80 microseconds followed by a high signal
-    // for ~80 microseconds again.
-    if (expectPulse(LOW) == TIMEOUT) {
-      DEBUG_PRINTLN(F("DHT timeout waiting for start signal low pulse."));
-      _lastresult = false;
-      return _lastresult;
-    }
-    if (expectPulse(HIGH) == TIMEOUT) {
-      DEBUG_PRINTLN(F("DHT timeout waiting for start signal high pulse."));
-      _lastresult = false;
-      return _lastresult;
-    }
-
-    // Now read the 40 bits sent by the sensor.  Each bit is sent as a 50
-    // microsecond low pulse followed by a variable length high pulse.  If the
-    // high pulse is ~28 microseconds then it's a 0 and if it's ~70 microseconds
-    // then it's a 1.  We measure the cycle count of the initial 50us low pulse
-    // and use that to compare to the cycle count of the high pulse to determine
-    // if the bit is a 0 (high state cycle count < low state cycle count), or a
-    // 1 (high state cycle count > low state cycle count). Note that for speed
-    // all the pulses are read into a array and then examined in a later step.
-    for (int i = 0; i < 80; i += 2) {
-      cycles[i] = expectPulse(LOW);
-      cycles[i + 1] = expectPulse(HIGH);
-    }
-  } // Timing critical code is now complete.
+  if (!capturePulses(cycles)) {
+    _lastresult = false;
+    return _lastresult;
+  }
 
   // Inspect pulses and determine which ones are 0 (high state cycle count < low
   // state cycle count), or 1 (high state cycle count > low state cycle count).
-  for (int i = 0; i < 40; ++i) {
-    uint32_t lowCycles = cycles[2 * i];
-    uint32_t highCycles = cycles[2 * i + 1];
-    if ((lowCycles == TIMEOUT) || (highCycles == TIMEOUT)) {
-      DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
-      _lastresult = false;
-      return _lastresult;
-    }
-    data[i / 8] <<= 1;
-    // Now compare the low and high cycle times to see if the bit is a 0 or 1.
-    if (highCycles > lowCycles) {
-      // High cycles are greater than 50us low cycle count, must be a 1.
-      data[i / 8] |= 1;
-    }
-    // Else high cycles are less than (or equal to, a weird case) the 50us low
-    // cycle count so this must be a zero.  Nothing needs to be changed in the
-    // stored data.
+  dht_decode_t result = dhtDecodePulses(cycles, data, _correct);
+  if (result == DHT_DECODE_TIMEOUT) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
+    _lastresult = false;
+    return _lastresult;
   }
 
   DEBUG_PRINTLN(F("Received from DHT:"));
@@ -346,7 +251,12 @@ bool DHT::read(bool force) {
   DEBUG_PRINTLN((data[0] + data[1] + data[2] + data[3]) & 0xFF, HEX);
 
   // Check we read 40 bits and that the checksum matches.
-  if (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
+  if (result == DHT_DECODE_OK || result == DHT_DECODE_CORRECTED) {
+    if (result == DHT_DECODE_CORRECTED) {
+      DEBUG_PRINTLN(F("DHT checksum failure corrected."));
+      _lastcorrected = true;
+      _corrections++;
+    }
     _lastresult = true;
     return _lastresult;
   } else {
@@ -356,6 +266,136 @@ bool DHT::read(bool force) {
   }
 }
 
+/*!
+ *  @brief  Read the raw 5 byte frame from sensor or return the last one from
+ *          less than two seconds ago.
+ *  @param  frame
+ *          buffer of 5 bytes that receives data[0..4] on success
+ *  @param  force
+ *          true if using force mode
+ *  @return true if the frame is valid
+ */
+bool DHT::readRaw(uint8_t* frame, bool force) {
+  if (!read(force)) {
+    return false;
+  }
+  memcpy(frame, data, sizeof(data));
+  return true;
+}
+
+/*!
+ *  @brief  Time of the last attempt to read the sensor over the bus
+ *          Cached results returned by read() keep this value, so it
+ *          identifies the frame the current readings came from.
+ *  @return millis() timestamp of the last bus read
+ */
+uint32_t DHT::lastReadTime() {
+  return _lastreadtime;
+}
+
+/*!
+ *  @brief  Frame of the last read, without reading the sensor
+ *  @return the 5 byte frame, or NULL if the last read failed
+ */
+const uint8_t* DHT::lastFrame() const {
+  return _lastresult ? data : NULL;
+}
+
+/*!
+ *  @brief  Type of sensor this object was created for
+ *  @return DHT11, DHT12, DHT21, DHT22 or AM2301
+ */
+uint8_t DHT::sensorType() const {
+  return _type;
+}
+
+/*!
+ *  @brief  Enable or disable single bit error correction
+ *          When enabled, a frame that fails the checksum and has exactly one
+ *          marginal bit is retried with that bit flipped, see
+ *          dhtDecodePulses().  Disabled by default.
+ *  @param  enable
+ *          true to enable error correction
+ */
+void DHT::setErrorCorrection(bool enable) {
+  _correct = enable;
+}
+
+/*!
+ *  @brief  Check whether the last frame read from the sensor was corrected
+ *  @return true if the last frame failed the checksum and was repaired
+ */
+bool DHT::lastReadCorrected() {
+  return _lastcorrected;
+}
+
+/*!
+ *  @brief  Number of frames repaired by error correction since startup
+ *  @return corrected frame count (wraps around at 65535)
+ */
+uint16_t DHT::correctedReadCount() {
+  return _corrections;
+}
+
+// Drive the data line low for usec microseconds.  delayMicroseconds() is only
+// accurate up to ~16ms on AVR, so use delay() for the long DHT11/12 start
+// pulse.
+void DHT::startSignal(uint16_t usec) {
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  if (usec > 16000) {
+    delay(usec / 1000);
+  } else {
+    delayMicroseconds(usec);
+  }
+}
+
+// End the start signal and capture the lengths (in loop cycles) of the 80
+// low/high pulses of the 40 data bits.  Returns false if the sensor did not
+// answer the start signal.
+bool DHT::capturePulses(uint32_t* cycles) {
+  uint32_t maxcycles =
+      microsecondsToClockCycles(1000); // 1 millisecond timeout for
+                                       // reading pulses from DHT sensor.
+
+  // End the start signal by setting data line high for 40 microseconds.
+  pinMode(_pin, INPUT_PULLUP);
+
+  // Delay a moment to let sensor pull data line low.
+  delayMicroseconds(pullTime);
+
+  // Now start reading the data line to get the value from the DHT sensor.
+
+  // Turn off interrupts temporarily because the next sections
+  // are timing critical and we don't want any interruptions.
+  InterruptLock lock;
+
+  // First expect a low signal for ~80 microseconds followed by a high signal
+  // for ~80 microseconds again.
+  if (expectPulse(LOW, maxcycles) == TIMEOUT) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for start signal low pulse."));
+    return false;
+  }
+  if (expectPulse(HIGH, maxcycles) == TIMEOUT) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for start signal high pulse."));
+    return false;
+  }
+
+  // Now read the 40 bits sent by the sensor.  Each bit is sent as a 50
+  // microsecond low pulse followed by a variable length high pulse.  If the
+  // high pulse is ~28 microseconds then it's a 0 and if it's ~70 microseconds
+  // then it's a 1.  We measure the cycle count of the initial 50us low pulse
+  // and use that to compare to the cycle count of the high pulse to determine
+  // if the bit is a 0 (high state cycle count < low state cycle count), or a
+  // 1 (high state cycle count > low state cycle count). Note that for speed
+  // all the pulses are read into a array and then examined in a later step.
+  for (int i = 0; i < 80; i += 2) {
+    cycles[i] = expectPulse(LOW, maxcycles);
+    cycles[i + 1] = expectPulse(HIGH, maxcycles);
+  }
+  return true;
+}
+
 // Expect the signal line to be at the specified level for a period of time and
 // return a count of loop cycles spent at that level (this cycle count can be
 // used to compare the relative time of two pulses).  If more than a millisecond
@@ -363,7 +403,7 @@ bool DHT::read(bool force) {
 // This is adapted from Arduino's pulseInLong function (which is only available
 // in the very latest IDE versions):
 //   https://github.com/arduino/Arduino/blob/master/hardware/arduino/avr/cores/arduino/wiring_pulse.c
-uint32_t DHT::expectPulse(bool level) {
+uint32_t DHT::expectPulse(bool level, uint32_t maxcycles) {
 // F_CPU is not be known at compile time on platforms such as STM32F103.
 // The preprocessor seems to evaluate it to zero in that case.
 #if (F_CPU > 16000000L) || (F_CPU == 0L)
@@ -376,7 +416,7 @@ uint32_t DHT::expectPulse(bool level) {
 #ifdef __AVR
   uint8_t portState = level ? _bit : 0;
   while ((*portInputRegister(_port) & _bit) == portState) {
-    if (count++ >= _maxcycles) {
+    if (count++ >= maxcycles) {
       return TIMEOUT; // Exceeded timeout, fail.
     }
   }
@@ -384,7 +424,7 @@ uint32_t DHT::expectPulse(bool level) {
 // ESP8266 right now, perhaps bugs in direct port access functions?).
 #else
   while (digitalRead(_pin) == level) {
-    if (count++ >= _maxcycles) {
+    if (count++ >= maxcycles) {
       return TIMEOUT; // Exceeded timeout, fail.
     }
   }
@@ -19,6 +19,7 @@
 #define DHT_H
 
 #include "Arduino.h"
+#include "DHT_Frame.h"
 
 /* Uncomment to enable printing out nice debug messages. */
 // #define DHT_DEBUG
@@ -40,13 +41,6 @@
   {} /**< Debug Print Line Placeholder if Debug is disabled */
 #endif
 
-/* Define types of sensors. */
-static const uint8_t DHT11{11};  /**< DHT TYPE 11 */
-static const uint8_t DHT12{12};  /**< DHY TYPE 12 */
-static const uint8_t DHT21{21};  /**< DHT TYPE 21 */
-static const uint8_t DHT22{22};  /**< DHT TYPE 22 */
-static const uint8_t AM2301{21}; /**< AM2301 */
-
 #if defined(TARGET_NAME) && (TARGET_NAME == ARDUINO_NANO33BLE)
 #ifndef microsecondsToClockCycles
 /*!
@@ -72,8 +66,21 @@ class DHT {
                          bool isFahrenheit = true);
   float readHumidity(bool force = false);
   bool read(bool force = false);
+  bool readRaw(uint8_t* frame, bool force = false);
+  uint32_t lastReadTime();
+  const uint8_t* lastFrame() const;
+  uint8_t sensorType() const;
+  void setErrorCorrection(bool enable);
+  bool lastReadCorrected();
+  uint16_t correctedReadCount();
 
  private:
+  friend class DHT_Unified;
+  friend class DHT_Mux;
+
+  // Members are ordered by size so 32 bit targets need no padding.
+  uint32_t _lastreadtime;
+  uint16_t _corrections; // Number of frames repaired so far
   uint8_t data[5];
   uint8_t _pin, _type;
 #ifdef __AVR
@@ -82,11 +89,14 @@ class DHT {
   // digitalRead.
   uint8_t _bit, _port;
 #endif
-  uint32_t _lastreadtime, _maxcycles;
-  bool _lastresult;
   uint8_t pullTime; // Time (in usec) to pull up data line before reading
+  bool _lastresult : 1;
+  bool _correct : 1;       // Try to repair frames that fail the checksum
+  bool _lastcorrected : 1; // Last frame was repaired by flipping a weak bit
 
-  uint32_t expectPulse(bool level);
+  void startSignal(uint16_t usec);
+  bool capturePulses(uint32_t* cycles);
+  uint32_t expectPulse(bool level, uint32_t maxcycles);
 };
 
 /*!
@@ -0,0 +1,148 @@
+/*!
+ *  @file DHT_Adaptive.cpp
+ *
+ *  Adaptive sampling interval for the DHT series of temperature/humidity
+ *  sensors.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Adaptive.h"
+
+// Milliseconds to whole seconds, rounded up and clamped to 16 bits.
+static uint16_t toSeconds(uint32_t msec) {
+  uint32_t seconds = msec / 1000 + (msec % 1000 != 0);
+  return seconds > UINT16_MAX ? UINT16_MAX : seconds;
+}
+
+/*!
+ *  @brief  Instantiates a new DHT_Adaptive class
+ *  @param  dht
+ *          sensor to read, begin() it as usual
+ *  @param  minInterval
+ *          shortest interval in milliseconds (at least 2000), rounded up to
+ *          whole seconds
+ *  @param  maxInterval
+ *          longest interval in milliseconds (at most about 18 hours), rounded
+ *          up to whole seconds
+ *  @param  deadband
+ *          largest change of temperature (C) and humidity (%) treated as
+ *          unchanged, in steps of 0.1
+ */
+DHT_Adaptive::DHT_Adaptive(DHT& dht, uint32_t minInterval,
+                           uint32_t maxInterval, float deadband)
+    : _dht(dht) {
+  _minInterval = toSeconds(
+      minInterval < DHT_MIN_INTERVAL ? DHT_MIN_INTERVAL : minInterval);
+  _maxInterval = toSeconds(maxInterval);
+  if (_maxInterval < _minInterval) {
+    _maxInterval = _minInterval;
+  }
+  _doublings = 0;
+  float tenths = deadband * 10 + 0.5F;
+  _deadband = tenths <= 0 ? 0 : tenths >= 255 ? 255 : (uint8_t)tenths;
+}
+
+/*!
+ *  @brief  Read value from sensor or return the last one if the sampling
+ *          interval has not passed yet.
+ *  @param  force
+ *          true if using force mode
+ *  @return true if the frame is valid
+ */
+bool DHT_Adaptive::read(bool force) {
+  // Failed reads are retried at the DHT class' own two second limit.
+  const uint8_t* frame = _dht.lastFrame();
+  if (!force && frame && (millis() - _dht.lastReadTime()) < sampleInterval()) {
+    return true; // return last correct measurement
+  }
+
+  // Keep the previous frame to decide how long to wait after this read.
+  uint8_t previous[5];
+  bool hadPrevious = frame != NULL;
+  if (hadPrevious) {
+    memcpy(previous, frame, sizeof(previous));
+  }
+
+  if (!_dht.read(force)) {
+    _doublings = 0;
+    return false;
+  }
+  if (!hadPrevious || !unchanged(previous)) {
+    _doublings = 0;
+  } else if (sampleInterval() < 1000UL * _maxInterval) {
+    _doublings++;
+  }
+  return true;
+}
+
+/*!
+ *  @brief  Read temperature
+ *  @param  S
+ *          Scale. Boolean value:
+ *					- true = Fahrenheit
+ *					- false = Celcius
+ *  @param  force
+ *          true if in force mode
+ *	@return Temperature value in selected scale
+ */
+float DHT_Adaptive::readTemperature(bool S, bool force) {
+  float f = NAN;
+
+  if (read(force)) {
+    f = dhtFrameTemperature(_dht.sensorType(), _dht.lastFrame());
+    if (S) {
+      f = _dht.convertCtoF(f);
+    }
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Read Humidity
+ *  @param  force
+ *					force read mode
+ *	@return float value - humidity in percent
+ */
+float DHT_Adaptive::readHumidity(bool force) {
+  float f = NAN;
+  if (read(force)) {
+    f = dhtFrameHumidity(_dht.sensorType(), _dht.lastFrame());
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Sampling interval currently in effect
+ *  @return interval between bus reads in milliseconds
+ */
+uint32_t DHT_Adaptive::sampleInterval() {
+  // read() stops doubling at the maximum, so this cannot overflow.
+  uint32_t seconds = (uint32_t)_minInterval << _doublings;
+  return 1000UL * (seconds < _maxInterval ? seconds : _maxInterval);
+}
+
+/*!
+ *  @brief  Sample rate currently in effect
+ *  @return bus reads per second
+ */
+float DHT_Adaptive::sampleRate() {
+  return 1000.0 / sampleInterval();
+}
+
+// Whether the frame just read moved by no more than the deadband from
+// previous, compared in tenths so 0.1 steps are not lost to rounding.
+bool DHT_Adaptive::unchanged(const uint8_t* previous) {
+  uint8_t type = _dht.sensorType();
+  const uint8_t* frame = _dht.lastFrame();
+  float temperature = dhtFrameTemperature(type, frame) -
+                      dhtFrameTemperature(type, previous);
+  float humidity =
+      dhtFrameHumidity(type, frame) - dhtFrameHumidity(type, previous);
+  return lround(fabs(temperature) * 10) <= _deadband &&
+         lround(fabs(humidity) * 10) <= _deadband;
+}
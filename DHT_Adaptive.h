@@ -0,0 +1,53 @@
+/*!
+ *  @file DHT_Adaptive.h
+ *
+ *  Adaptive sampling interval for the DHT series of temperature/humidity
+ *  sensors.  The interval between bus reads grows while readings hold still
+ *  and drops back to its minimum as soon as they move, so a slowly changing
+ *  room is sampled a few dozen times an hour instead of every two seconds.
+ *  It wraps a DHT object, which pays nothing for the feature when it is not
+ *  used.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  Written by Adafruit Industries.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_ADAPTIVE_H
+#define DHT_ADAPTIVE_H
+
+#include "DHT.h"
+
+/*!
+ *  @brief  Class that reads a DHT at an interval adapted to how fast its
+ *          readings change
+ *
+ *  Every frame that differs from the previous one by no more than the
+ *  deadband doubles the interval, up to the maximum; a larger change or a
+ *  failed read drops it back to the minimum.  Between samples read() returns
+ *  the cached frame.  Both bounds are kept in whole seconds.
+ */
+class DHT_Adaptive {
+ public:
+  DHT_Adaptive(DHT& dht, uint32_t minInterval, uint32_t maxInterval,
+               float deadband = 0.2);
+  bool read(bool force = false);
+  float readTemperature(bool S = false, bool force = false);
+  float readHumidity(bool force = false);
+  uint32_t sampleInterval();
+  float sampleRate();
+
+ private:
+  DHT& _dht;
+  uint16_t _minInterval, _maxInterval; // Bounds of the interval in seconds
+  uint8_t _doublings; // Times the minimum interval has been doubled
+  uint8_t _deadband;  // Change (in 0.1 C or %RH) still considered unchanged
+
+  bool unchanged(const uint8_t* previous);
+};
+
+#endif
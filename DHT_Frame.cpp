@@ -0,0 +1,508 @@
+/*!
+ *  @file DHT_Frame.cpp
+ *
+ *  Decoding of raw 5 byte DHT frames.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Frame.h"
+
+#include <math.h>
+#include <string.h>
+
+// Keep the model table in flash on AVR, where const data is otherwise copied
+// to RAM at startup.
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MODEL_PROGMEM PROGMEM
+#define readModelByte(addr) pgm_read_byte(addr)
+#define readModelWord(addr) pgm_read_word(addr)
+#define copyModel(dst, src) memcpy_P(dst, src, sizeof(dht_model_t))
+#else
+#define MODEL_PROGMEM
+#define readModelByte(addr) (*(addr))
+#define readModelWord(addr) (*(addr))
+#define copyModel(dst, src) memcpy(dst, src, sizeof(dht_model_t))
+#endif
+
+// Everything that differs between the supported models.  The start pulse
+// data sheets ask for is "at least 1ms" for DHT21/22 and at least 18ms for
+// DHT11/12 (20ms just to be safe).
+static const dht_model_t models[] MODEL_PROGMEM = {
+    {DHT11, DHT_FORMAT_11, "DHT11", 20000, 1, 0.0F, 50.0F, 2.0F, 20.0F, 80.0F,
+     5.0F},
+    {DHT12, DHT_FORMAT_12, "DHT12", 20000, 2, -20.0F, 60.0F, 0.5F, 20.0F,
+     95.0F, 5.0F},
+    {DHT21, DHT_FORMAT_22, "DHT21", 1100, 2, -40.0F, 80.0F, 0.1F, 0.0F, 100.0F,
+     0.1F},
+    {DHT22, DHT_FORMAT_22, "DHT22", 1100, 2, -40.0F, 125.0F, 0.1F, 0.0F,
+     100.0F, 0.1F},
+};
+
+#define MODEL_COUNT (sizeof(models) / sizeof(models[0])) /**< Table size */
+
+#define UNKNOWN_START_PULSE 20000 /**< Start pulse for unknown types in usec */
+
+// The bulk decoder uses SSE2 or AVX2 when the compiler targets them (e.g.
+// -msse2, which is the x86-64 default, or -mavx2) and plain C++ otherwise.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DHT_FRAME_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define DHT_FRAME_SSE2
+#endif
+
+// Index of type in the model table, or MODEL_COUNT if it is unknown.
+static uint8_t modelIndex(uint8_t type) {
+  uint8_t i = 0;
+  while (i < MODEL_COUNT && readModelByte(&models[i].type) != type) {
+    i++;
+  }
+  return i;
+}
+
+// Frame layout of type, one of DHT_FORMAT_*.
+static uint8_t modelFormat(uint8_t type) {
+  uint8_t i = modelIndex(type);
+  return i < MODEL_COUNT ? readModelByte(&models[i].format)
+                         : DHT_FORMAT_UNKNOWN;
+}
+
+/*!
+ *  @brief  Look up the constants of a sensor model
+ *  @param  type
+ *          type of sensor
+ *  @param  model
+ *          receives the model constants; for an unknown type the name is
+ *          "DHT?", the start pulse and minimum delay are the slowest ones of
+ *          the known models and the ranges are 0
+ *  @return true if type is a known model
+ */
+bool dhtModel(uint8_t type, dht_model_t* model) {
+  uint8_t i = modelIndex(type);
+  if (i < MODEL_COUNT) {
+    copyModel(model, &models[i]);
+    return true;
+  }
+  memset(model, 0, sizeof(dht_model_t));
+  model->type = type;
+  model->format = DHT_FORMAT_UNKNOWN;
+  strcpy(model->name, "DHT?");
+  model->startPulse = UNKNOWN_START_PULSE;
+  model->minDelay = 2;
+  return false;
+}
+
+/*!
+ *  @brief  Look up the start pulse of a sensor model without copying its
+ *          other constants
+ *  @param  type
+ *          type of sensor
+ *  @return time in microseconds to hold the data line low, the slowest one
+ *          of the known models for an unknown type
+ */
+uint16_t dhtStartPulse(uint8_t type) {
+  uint8_t i = modelIndex(type);
+  return i < MODEL_COUNT ? readModelWord(&models[i].startPulse)
+                         : UNKNOWN_START_PULSE;
+}
+
+// Flip bit i (0 = MSB of frame[0], 39 = LSB of frame[4]) of a 40 bit frame.
+static void flipBit(uint8_t* frame, uint8_t i) {
+  frame[i / 8] ^= 0x80 >> (i % 8);
+}
+
+/*!
+ *  @brief  Turn the 40 low/high pulse pairs of a transmission into a frame
+ *          Each bit is sent as a ~50 microsecond low pulse followed by a high
+ *          pulse of ~28 microseconds for a 0 or ~70 microseconds for a 1, so a
+ *          bit is a 1 when its high pulse is longer than its low pulse.  The
+ *          pulse lengths may be in any unit (loop cycles, nanoseconds, ...).
+ *  @param  pulses
+ *          80 pulse lengths: low, high, low, high, ...; DHT_PULSE_TIMEOUT for
+ *          a pulse that never ended
+ *  @param  frame
+ *          receives the 5 byte frame
+ *  @param  correct
+ *          true to repair a checksum failure by flipping the one marginal
+ *          bit, see below
+ *  @return decode result
+ *
+ *  A bit is marginal when its high pulse is within a quarter of its low
+ *  pulse.  Correction only happens if exactly one bit of the frame is
+ *  marginal and flipping it makes the checksum match; a frame with two or
+ *  more marginal bits is rejected.  The checksum is a byte sum and only sees
+ *  the weight of a bit, so a frame with a wrong bit that is not marginal and
+ *  a correct marginal bit of the same weight in another byte can still be
+ *  "corrected" to a wrong value.  In the corpus test in extras/test about 6%
+ *  of the frames with exactly that fault are, the rest are rejected; frames
+ *  whose only error is the marginal bit are always repaired.
+ */
+dht_decode_t dhtDecodePulses(const uint32_t* pulses, uint8_t* frame,
+                             bool correct) {
+  // While decoding, count the marginal bits and remember the last one.
+  uint8_t marginal = 0, weakest = 0;
+
+  frame[0] = frame[1] = frame[2] = frame[3] = frame[4] = 0;
+
+  // Inspect pulses and determine which ones are 0 (high state cycle count < low
+  // state cycle count), or 1 (high state cycle count > low state cycle count).
+  for (uint8_t i = 0; i < 40; ++i) {
+    uint32_t lowCycles = pulses[2 * i];
+    uint32_t highCycles = pulses[2 * i + 1];
+    if ((lowCycles == DHT_PULSE_TIMEOUT) || (highCycles == DHT_PULSE_TIMEOUT)) {
+      return DHT_DECODE_TIMEOUT;
+    }
+    frame[i / 8] <<= 1;
+    // Now compare the low and high cycle times to see if the bit is a 0 or 1.
+    if (highCycles > lowCycles) {
+      // High cycles are greater than 50us low cycle count, must be a 1.
+      frame[i / 8] |= 1;
+    }
+    // Else high cycles are less than (or equal to, a weird case) the 50us low
+    // cycle count so this must be a zero.  Nothing needs to be changed in the
+    // stored data.
+
+    uint32_t margin = (highCycles > lowCycles) ? highCycles - lowCycles
+                                               : lowCycles - highCycles;
+    if (margin <= lowCycles / 4) {
+      marginal++;
+      weakest = i;
+    }
+  }
+
+  // Check we read 40 bits and that the checksum matches.
+  if (dhtFrameValid(frame)) {
+    return DHT_DECODE_OK;
+  } else if (correct && marginal == 1) {
+    flipBit(frame, weakest);
+    if (dhtFrameValid(frame)) {
+      return DHT_DECODE_CORRECTED;
+    }
+    flipBit(frame, weakest);
+  }
+  return DHT_DECODE_CHECKSUM;
+}
+
+/*!
+ *  @brief  Check the checksum of a raw frame
+ *  @param  frame
+ *          5 byte frame as sent by the sensor
+ *  @return true if data[4] matches the sum of data[0..3]
+ */
+bool dhtFrameValid(const uint8_t* frame) {
+  return frame[4] == ((frame[0] + frame[1] + frame[2] + frame[3]) & 0xFF);
+}
+
+// A fused multiply-add would skip the rounding of the product in single
+// precision, so contraction is turned off for the conversions below; in double
+// precision it cannot change the float result for the 16 bit inputs of a
+// frame.  extras/test/test_frame checks the scalar and vector code in both
+// precisions, with and without FMA.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+// a + b * 0.1 rounded to float, evaluated in double precision or, if single
+// is set, with every operation rounded to float as on targets where double is
+// 32 bits wide (AVR).
+static float scaleTenth(int16_t a, uint16_t b, bool single) {
+  if (single) {
+    float tenths = b * 0.1F;
+    return a + tenths;
+  }
+  return a + b * 0.1;
+}
+
+// Temperature of a frame in the given format, see dhtFrameTemperature().
+static float temperatureOf(uint8_t format, const uint8_t* frame,
+                           bool single) {
+  float f = NAN;
+
+  switch (format) {
+    case DHT_FORMAT_11: {
+      int16_t a = frame[2];
+      if (frame[3] & 0x80) {
+        a = -1 - a;
+      }
+      f = scaleTenth(a, frame[3] & 0x0f, single);
+      break;
+    }
+    case DHT_FORMAT_12:
+      f = scaleTenth(frame[2], frame[3] & 0x0f, single);
+      if (frame[2] & 0x80) {
+        f *= -1;
+      }
+      break;
+    case DHT_FORMAT_22:
+      f = scaleTenth(0, ((uint16_t)(frame[2] & 0x7F)) << 8 | frame[3], single);
+      if (frame[2] & 0x80) {
+        f *= -1;
+      }
+      break;
+  }
+  return f;
+}
+
+// Humidity of a frame in the given format, see dhtFrameHumidity().
+static float humidityOf(uint8_t format, const uint8_t* frame, bool single) {
+  float f = NAN;
+
+  switch (format) {
+    case DHT_FORMAT_11:
+    case DHT_FORMAT_12:
+      f = scaleTenth(frame[0], frame[1], single);
+      break;
+    case DHT_FORMAT_22:
+      f = scaleTenth(0, ((uint16_t)frame[0]) << 8 | frame[1], single);
+      break;
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Convert a raw frame to temperature
+ *  @param  type
+ *          type of sensor
+ *  @param  frame
+ *          5 byte frame as sent by the sensor (the checksum is not checked)
+ *  @return temperature in Celcius, NAN for an unknown sensor type
+ */
+float dhtFrameTemperature(uint8_t type, const uint8_t* frame) {
+  return temperatureOf(modelFormat(type), frame, false);
+}
+
+/*!
+ *  @brief  Convert a raw frame to relative humidity
+ *  @param  type
+ *          type of sensor
+ *  @param  frame
+ *          5 byte frame as sent by the sensor (the checksum is not checked)
+ *  @return humidity in percent, NAN for an unknown sensor type
+ */
+float dhtFrameHumidity(uint8_t type, const uint8_t* frame) {
+  return humidityOf(modelFormat(type), frame, false);
+}
+
+// The vector code below computes a, b and the sign of every conversion above
+// per lane and repeats the arithmetic of scaleTenth(), so it returns the same
+// bits as the scalar code in both precisions.
+
+#if defined(DHT_FRAME_AVX2)
+
+// scaleTenth() for 8 lanes.
+static inline __m256 scaleTenth8(__m256i a, __m256i b, bool single) {
+  if (single) {
+    __m256 tenths = _mm256_mul_ps(_mm256_cvtepi32_ps(b), _mm256_set1_ps(0.1F));
+    return _mm256_add_ps(_mm256_cvtepi32_ps(a), tenths);
+  }
+  const __m256d tenth = _mm256_set1_pd(0.1);
+  __m128 lo = _mm256_cvtpd_ps(_mm256_add_pd(
+      _mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+      _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(b)), tenth)));
+  __m128 hi = _mm256_cvtpd_ps(_mm256_add_pd(
+      _mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+      _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1)),
+                    tenth)));
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+// Decode 8 frames (40 bytes) starting at frames.  Returns the bitmask of
+// valid frames.
+static int decode8(uint8_t format, const uint8_t* frames, bool single,
+                   float* temperature, float* humidity) {
+  const __m256i offsets = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 30, 35);
+  const __m256i byteMask = _mm256_set1_epi32(0xFF);
+  // Bytes 0..3 and 1..4 of every frame, the latter to reach the checksum
+  // without reading past the last frame.
+  __m256i lo = _mm256_i32gather_epi32((const int*)frames, offsets, 1);
+  __m256i hi = _mm256_i32gather_epi32((const int*)(frames + 1), offsets, 1);
+  __m256i b0 = _mm256_and_si256(lo, byteMask);
+  __m256i b1 = _mm256_and_si256(_mm256_srli_epi32(lo, 8), byteMask);
+  __m256i b2 = _mm256_and_si256(_mm256_srli_epi32(lo, 16), byteMask);
+  __m256i b3 = _mm256_srli_epi32(lo, 24);
+  __m256i b4 = _mm256_srli_epi32(hi, 24);
+
+  __m256i sum = _mm256_add_epi32(_mm256_add_epi32(b0, b1),
+                                 _mm256_add_epi32(b2, b3));
+  __m256i valid = _mm256_cmpeq_epi32(_mm256_and_si256(sum, byteMask), b4);
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i x80 = _mm256_set1_epi32(0x80);
+  const __m256i x0f = _mm256_set1_epi32(0x0F);
+  __m256i tA, tB, tSign, hA, hB;
+  if (format != DHT_FORMAT_22) {
+    tB = _mm256_and_si256(b3, x0f);
+    if (format == DHT_FORMAT_11) {
+      // a = (data[3] & 0x80) ? -1 - data[2] : data[2]
+      __m256i neg = _mm256_cmpeq_epi32(_mm256_and_si256(b3, x80), x80);
+      __m256i flipped = _mm256_sub_epi32(_mm256_set1_epi32(-1), b2);
+      tA = _mm256_blendv_epi8(b2, flipped, neg);
+      tSign = zero;
+    } else {
+      tA = b2;
+      tSign = _mm256_and_si256(b2, x80);
+    }
+    hA = b0;
+    hB = b1;
+  } else {
+    tA = zero;
+    tB = _mm256_or_si256(
+        _mm256_slli_epi32(_mm256_and_si256(b2, _mm256_set1_epi32(0x7F)), 8),
+        b3);
+    tSign = _mm256_and_si256(b2, x80);
+    hA = zero;
+    hB = _mm256_or_si256(_mm256_slli_epi32(b0, 8), b1);
+  }
+
+  // f *= -1 only flips the sign bit, so move bit 7 of the sign byte to 31.
+  __m256 t = _mm256_xor_ps(scaleTenth8(tA, tB, single),
+                           _mm256_castsi256_ps(_mm256_slli_epi32(tSign, 24)));
+  __m256 h = scaleTenth8(hA, hB, single);
+  __m256 validps = _mm256_castsi256_ps(valid);
+  const __m256 nan = _mm256_set1_ps(NAN);
+  _mm256_storeu_ps(temperature, _mm256_blendv_ps(nan, t, validps));
+  _mm256_storeu_ps(humidity, _mm256_blendv_ps(nan, h, validps));
+  return _mm256_movemask_ps(validps);
+}
+
+#define DHT_FRAME_BLOCK 8 /**< Frames per vector iteration */
+#define decodeBlock decode8 /**< Vector kernel */
+
+#elif defined(DHT_FRAME_SSE2)
+
+// SSE2 has no blendv, select with and/andnot/or.
+static inline __m128i selectEpi32(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// scaleTenth() for 4 lanes.
+static inline __m128 scaleTenth4(__m128i a, __m128i b, bool single) {
+  if (single) {
+    __m128 tenths = _mm_mul_ps(_mm_cvtepi32_ps(b), _mm_set1_ps(0.1F));
+    return _mm_add_ps(_mm_cvtepi32_ps(a), tenths);
+  }
+  const __m128d tenth = _mm_set1_pd(0.1);
+  __m128 lo = _mm_cvtpd_ps(_mm_add_pd(
+      _mm_cvtepi32_pd(a), _mm_mul_pd(_mm_cvtepi32_pd(b), tenth)));
+  __m128 hi = _mm_cvtpd_ps(
+      _mm_add_pd(_mm_cvtepi32_pd(_mm_srli_si128(a, 8)),
+                 _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(b, 8)), tenth)));
+  return _mm_movelh_ps(lo, hi);
+}
+
+// Decode 4 frames (20 bytes) starting at frames.  Returns the bitmask of
+// valid frames.
+static int decode4(uint8_t format, const uint8_t* frames, bool single,
+                   float* temperature, float* humidity) {
+  const uint8_t* f = frames;
+  __m128i b0 = _mm_setr_epi32(f[0], f[5], f[10], f[15]);
+  __m128i b1 = _mm_setr_epi32(f[1], f[6], f[11], f[16]);
+  __m128i b2 = _mm_setr_epi32(f[2], f[7], f[12], f[17]);
+  __m128i b3 = _mm_setr_epi32(f[3], f[8], f[13], f[18]);
+  __m128i b4 = _mm_setr_epi32(f[4], f[9], f[14], f[19]);
+
+  __m128i sum = _mm_add_epi32(_mm_add_epi32(b0, b1), _mm_add_epi32(b2, b3));
+  __m128i valid = _mm_cmpeq_epi32(_mm_and_si128(sum, _mm_set1_epi32(0xFF)), b4);
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i x80 = _mm_set1_epi32(0x80);
+  const __m128i x0f = _mm_set1_epi32(0x0F);
+  __m128i tA, tB, tSign, hA, hB;
+  if (format != DHT_FORMAT_22) {
+    tB = _mm_and_si128(b3, x0f);
+    if (format == DHT_FORMAT_11) {
+      // a = (data[3] & 0x80) ? -1 - data[2] : data[2]
+      __m128i neg = _mm_cmpeq_epi32(_mm_and_si128(b3, x80), x80);
+      tA = selectEpi32(neg, _mm_sub_epi32(_mm_set1_epi32(-1), b2), b2);
+      tSign = zero;
+    } else {
+      tA = b2;
+      tSign = _mm_and_si128(b2, x80);
+    }
+    hA = b0;
+    hB = b1;
+  } else {
+    tA = zero;
+    tB = _mm_or_si128(
+        _mm_slli_epi32(_mm_and_si128(b2, _mm_set1_epi32(0x7F)), 8), b3);
+    tSign = _mm_and_si128(b2, x80);
+    hA = zero;
+    hB = _mm_or_si128(_mm_slli_epi32(b0, 8), b1);
+  }
+
+  // f *= -1 only flips the sign bit, so move bit 7 of the sign byte to 31.
+  __m128 t = _mm_xor_ps(scaleTenth4(tA, tB, single),
+                        _mm_castsi128_ps(_mm_slli_epi32(tSign, 24)));
+  __m128 h = scaleTenth4(hA, hB, single);
+  __m128 validps = _mm_castsi128_ps(valid);
+  __m128 nan = _mm_andnot_ps(validps, _mm_set1_ps(NAN));
+  _mm_storeu_ps(temperature, _mm_or_ps(_mm_and_ps(validps, t), nan));
+  _mm_storeu_ps(humidity, _mm_or_ps(_mm_and_ps(validps, h), nan));
+  return _mm_movemask_ps(validps);
+}
+
+#define DHT_FRAME_BLOCK 4 /**< Frames per vector iteration */
+#define decodeBlock decode4 /**< Vector kernel */
+
+#endif
+
+/*!
+ *  @brief  Validate and convert an array of raw frames
+ *          Results are identical to calling dhtFrameValid(),
+ *          dhtFrameTemperature() and dhtFrameHumidity() for every frame on
+ *          the machine running this function; SSE2/AVX2 is used when the
+ *          compiler targets it.  Frames logged by a sensor node on a target
+ *          where double is 32 bits wide (AVR) convert to slightly different
+ *          floats there, about one DHT22 value in five is off by one ulp; set
+ *          singlePrecision to reproduce the node's results on a host.
+ *  @param  type
+ *          type of sensor that sent all frames
+ *  @param  frames
+ *          count frames of 5 bytes each, packed back to back
+ *  @param  count
+ *          number of frames
+ *  @param  temperature
+ *          receives count temperatures in Celcius, NAN for invalid frames
+ *  @param  humidity
+ *          receives count humidities in percent, NAN for invalid frames
+ *  @param  singlePrecision
+ *          true to round every operation to float like a target with a 32 bit
+ *          double, false to convert like this machine's dhtFrameTemperature()
+ *          and dhtFrameHumidity()
+ *  @return number of frames with a valid checksum
+ */
+size_t dhtDecodeFrames(uint8_t type, const uint8_t* frames, size_t count,
+                       float* temperature, float* humidity,
+                       bool singlePrecision) {
+  bool single = singlePrecision || sizeof(double) == sizeof(float);
+  uint8_t format = modelFormat(type);
+  size_t i = 0, valid = 0;
+#ifdef DHT_FRAME_BLOCK
+  if (format != DHT_FORMAT_UNKNOWN) {
+    for (; i + DHT_FRAME_BLOCK <= count; i += DHT_FRAME_BLOCK) {
+      valid += __builtin_popcount(decodeBlock(
+          format, frames + 5 * i, single, temperature + i, humidity + i));
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    const uint8_t* frame = frames + 5 * i;
+    if (dhtFrameValid(frame)) {
+      temperature[i] = temperatureOf(format, frame, single);
+      humidity[i] = humidityOf(format, frame, single);
+      valid++;
+    } else {
+      temperature[i] = humidity[i] = NAN;
+    }
+  }
+  return valid;
+}
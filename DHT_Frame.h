@@ -0,0 +1,77 @@
+/*!
+ *  @file DHT_Frame.h
+ *
+ *  Decoding of raw 5 byte DHT frames (checksum validation and conversion to
+ *  temperature and humidity).  These are pure functions without Arduino
+ *  dependencies, shared by the DHT class and usable on a host, e.g. by a
+ *  gateway that receives raw frames from many nodes.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  Written by Adafruit Industries.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_FRAME_H
+#define DHT_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Define types of sensors. */
+static const uint8_t DHT11{11};  /**< DHT TYPE 11 */
+static const uint8_t DHT12{12};  /**< DHY TYPE 12 */
+static const uint8_t DHT21{21};  /**< DHT TYPE 21 */
+static const uint8_t DHT22{22};  /**< DHT TYPE 22 */
+static const uint8_t AM2301{21}; /**< AM2301 */
+
+#define DHT_FORMAT_11 0 /**< Integer and tenths bytes, sign in data[3] */
+#define DHT_FORMAT_12 1 /**< Integer and tenths bytes, sign in data[2] */
+#define DHT_FORMAT_22 2 /**< 16 bit tenths, sign and magnitude */
+#define DHT_FORMAT_UNKNOWN 0xFF /**< Sensor type not in the model table */
+
+/*!
+ *  @brief  Constants describing one sensor model
+ */
+typedef struct {
+  uint8_t type;                /**< DHT11, DHT12, DHT21 or DHT22 */
+  uint8_t format;              /**< Frame layout, one of DHT_FORMAT_* */
+  char name[6];                /**< Model name */
+  uint16_t startPulse;         /**< Start signal low time in microseconds */
+  uint8_t minDelay;            /**< Minimum time between reads in seconds */
+  float temperatureMin;        /**< Lowest temperature in Celcius */
+  float temperatureMax;        /**< Highest temperature in Celcius */
+  float temperatureResolution; /**< Temperature resolution in Celcius */
+  float humidityMin;           /**< Lowest relative humidity in percent */
+  float humidityMax;           /**< Highest relative humidity in percent */
+  float humidityResolution;    /**< Humidity resolution in percent */
+} dht_model_t;
+
+#define DHT_MIN_INTERVAL 2000        /**< Minimum time between reads in msec */
+#define DHT_PULSE_TIMEOUT UINT32_MAX /**< Pulse length marking a timeout */
+
+/*!
+ *  @brief  Result of decoding the pulses of a frame
+ */
+typedef enum {
+  DHT_DECODE_OK,        /**< Frame matches its checksum */
+  DHT_DECODE_CORRECTED, /**< Frame was repaired by flipping weak bits */
+  DHT_DECODE_TIMEOUT,   /**< A pulse timed out */
+  DHT_DECODE_CHECKSUM,  /**< Frame does not match its checksum */
+} dht_decode_t;
+
+bool dhtModel(uint8_t type, dht_model_t* model);
+uint16_t dhtStartPulse(uint8_t type);
+dht_decode_t dhtDecodePulses(const uint32_t* pulses, uint8_t* frame,
+                             bool correct);
+bool dhtFrameValid(const uint8_t* frame);
+float dhtFrameTemperature(uint8_t type, const uint8_t* frame);
+float dhtFrameHumidity(uint8_t type, const uint8_t* frame);
+size_t dhtDecodeFrames(uint8_t type, const uint8_t* frames, size_t count,
+                       float* temperature, float* humidity,
+                       bool singlePrecision = false);
+
+#endif
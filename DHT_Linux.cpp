@@ -0,0 +1,352 @@
+/*!
+ *  @file DHT_Linux.cpp
+ *
+ *  Linux backend for the DHT series of temperature/humidity sensors.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Linux.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <math.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#define EDGE_BATCH 32   /**< Edge events read from the kernel at once */
+#define QUIET_USEC 2000 /**< Idle line time that ends a transmission */
+
+// Milliseconds from the monotonic clock, wrapping like Arduino's millis().
+static uint32_t millis() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static struct timespec toTimespec(uint32_t usec) {
+  struct timespec ts;
+  ts.tv_sec = usec / 1000000;
+  ts.tv_nsec = (usec % 1000000) * 1000L;
+  return ts;
+}
+
+/*!
+ *  @brief  Instantiates a new DHT_GpioEdgeSource class
+ *  @param  chip
+ *          path of the GPIO character device, e.g. "/dev/gpiochip0"
+ *  @param  line
+ *          line offset on that chip the DHT data pin is connected to
+ */
+DHT_GpioEdgeSource::DHT_GpioEdgeSource(const char* chip, uint32_t line)
+    : _chip(chip), _line(line), _fd(-1), _seqno(0) {}
+
+DHT_GpioEdgeSource::~DHT_GpioEdgeSource() {
+  if (_fd >= 0) {
+    close(_fd);
+  }
+}
+
+/*!
+ *  @brief  Request the line from the kernel as a pulled up input
+ *  @return true on success
+ */
+bool DHT_GpioEdgeSource::begin() {
+  int chip = open(_chip, O_RDWR | O_CLOEXEC);
+  if (chip < 0) {
+    return false;
+  }
+  struct gpio_v2_line_request request;
+  memset(&request, 0, sizeof(request));
+  request.offsets[0] = _line;
+  request.num_lines = 1;
+  strncpy(request.consumer, "DHT", sizeof(request.consumer) - 1);
+  request.config.flags =
+      GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_BIAS_PULL_UP;
+  // The kernel default of 16 events per line is far too small to hold the
+  // ~84 edges of one transmission if we get preempted while it arrives.
+  request.event_buffer_size = DHT_LINUX_MAX_EDGES;
+  int result = ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &request);
+  close(chip);
+  if (result < 0) {
+    return false;
+  }
+  _fd = request.fd;
+  return true;
+}
+
+/*!
+ *  @brief  Drive the line low, then release it with both edge detection on
+ *  @param  usec
+ *          time in microseconds to hold the data line low
+ *  @return true on success
+ */
+bool DHT_GpioEdgeSource::start(uint32_t usec) {
+  // Outputs start at value 0, i.e. driven low.
+  if (!configure(GPIO_V2_LINE_FLAG_OUTPUT)) {
+    return false;
+  }
+  struct timespec ts = toTimespec(usec);
+  clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+  // Release the line and timestamp every edge from here on.
+  _seqno = 0;
+  return configure(GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_BIAS_PULL_UP |
+                   GPIO_V2_LINE_FLAG_EDGE_RISING |
+                   GPIO_V2_LINE_FLAG_EDGE_FALLING);
+}
+
+/*!
+ *  @brief  Read a batch of edge events
+ *  @param  edges
+ *          receives up to max edges in the order they occurred
+ *  @param  max
+ *          capacity of edges
+ *  @param  usec
+ *          time in microseconds to wait for the first edge
+ *  @return number of edges read, 0 on timeout or -1 on error or if the kernel
+ *          dropped edges
+ */
+int DHT_GpioEdgeSource::readEdges(dht_edge_t* edges, int max, uint32_t usec) {
+  struct pollfd pfd = {_fd, POLLIN, 0};
+  struct timespec ts = toTimespec(usec);
+  int ready = ppoll(&pfd, 1, &ts, NULL);
+  if (ready <= 0) {
+    return ready;
+  }
+
+  struct gpio_v2_line_event events[EDGE_BATCH];
+  if (max > EDGE_BATCH) {
+    max = EDGE_BATCH;
+  }
+  ssize_t bytes = ::read(_fd, events, max * sizeof(events[0]));
+  if (bytes < 0) {
+    return -1;
+  }
+  int count = bytes / sizeof(events[0]);
+  for (int i = 0; i < count; i++) {
+    // line_seqno counts every edge the kernel saw, so a gap means the event
+    // buffer overflowed and the pulse train is incomplete.
+    if (_seqno && events[i].line_seqno != _seqno) {
+      return -1;
+    }
+    _seqno = events[i].line_seqno + 1;
+    edges[i].timestamp = events[i].timestamp_ns;
+    edges[i].rising = events[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE;
+  }
+  return count;
+}
+
+/*!
+ *  @brief  Turn edge detection off, drop unread edges and leave the line
+ *          pulled up
+ */
+void DHT_GpioEdgeSource::stop() {
+  configure(GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_BIAS_PULL_UP);
+  struct pollfd pfd = {_fd, POLLIN, 0};
+  struct gpio_v2_line_event events[EDGE_BATCH];
+  while (poll(&pfd, 1, 0) > 0) {
+    if (::read(_fd, events, sizeof(events)) <= 0) {
+      break;
+    }
+  }
+}
+
+// Reconfigure the requested line with the given gpio_v2_line_flag bits.
+bool DHT_GpioEdgeSource::configure(uint64_t flags) {
+  struct gpio_v2_line_config config;
+  memset(&config, 0, sizeof(config));
+  config.flags = flags;
+  return ioctl(_fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) >= 0;
+}
+
+/*!
+ *  @brief  Instantiates a new DHT_Linux class
+ *  @param  source
+ *          edge source for the sensor's data line
+ *  @param  type
+ *          type of sensor
+ */
+DHT_Linux::DHT_Linux(DHT_EdgeSource& source, uint8_t type)
+    : _source(source), _type(type), _lastresult(false), _correct(false),
+      _lastcorrected(false), _corrections(0) {}
+
+/*!
+ *  @brief  Acquire the data line
+ *  @return true on success
+ */
+bool DHT_Linux::begin() {
+  // Using this value makes sure that millis() - lastreadtime will be
+  // >= DHT_MIN_INTERVAL right away. Note that this assignment wraps
+  // around, but so will the subtraction.
+  _lastreadtime = millis() - DHT_MIN_INTERVAL;
+  return _source.begin();
+}
+
+/*!
+ *  @brief  Read temperature
+ *  @param  S
+ *          Scale. Boolean value:
+ *					- true = Fahrenheit
+ *					- false = Celcius
+ *  @param  force
+ *          true if in force mode
+ *	@return Temperature value in selected scale
+ */
+float DHT_Linux::readTemperature(bool S, bool force) {
+  float f = NAN;
+
+  if (read(force)) {
+    f = dhtFrameTemperature(_type, data);
+    if (S) {
+      f = f * 1.8 + 32;
+    }
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Read Humidity
+ *  @param  force
+ *					force read mode
+ *	@return float value - humidity in percent
+ */
+float DHT_Linux::readHumidity(bool force) {
+  float f = NAN;
+  if (read(force)) {
+    f = dhtFrameHumidity(_type, data);
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Read the raw 5 byte frame from sensor or return the last one from
+ *          less than two seconds ago.
+ *  @param  frame
+ *          buffer of 5 bytes that receives data[0..4] on success
+ *  @param  force
+ *          true if using force mode
+ *  @return true if the frame is valid
+ */
+bool DHT_Linux::readRaw(uint8_t* frame, bool force) {
+  if (!read(force)) {
+    return false;
+  }
+  memcpy(frame, data, sizeof(data));
+  return true;
+}
+
+/*!
+ *  @brief  Enable or disable single bit error correction, see
+ *          dhtDecodePulses().  Disabled by default.
+ *  @param  enable
+ *          true to enable error correction
+ */
+void DHT_Linux::setErrorCorrection(bool enable) {
+  _correct = enable;
+}
+
+/*!
+ *  @brief  Check whether the last frame read from the sensor was corrected
+ *  @return true if the last frame failed the checksum and was repaired
+ */
+bool DHT_Linux::lastReadCorrected() {
+  return _lastcorrected;
+}
+
+/*!
+ *  @brief  Number of frames repaired by error correction since startup
+ *  @return corrected frame count (wraps around at 65535)
+ */
+uint16_t DHT_Linux::correctedReadCount() {
+  return _corrections;
+}
+
+/*!
+ *  @brief  Read value from sensor or return last one from less than two
+ *seconds.
+ *  @param  force
+ *          true if using force mode
+ *	@return true if the frame is valid
+ */
+bool DHT_Linux::read(bool force) {
+  // Check if sensor was read less than two seconds ago and return early
+  // to use last reading.
+  uint32_t currenttime = millis();
+  if (!force && ((currenttime - _lastreadtime) < DHT_MIN_INTERVAL)) {
+    return _lastresult; // return last correct measurement
+  }
+  _lastreadtime = currenttime;
+  _lastcorrected = false;
+
+  uint32_t pulses[80];
+  if (!capture(pulses)) {
+    _lastresult = false;
+    return _lastresult;
+  }
+  dht_decode_t result = dhtDecodePulses(pulses, data, _correct);
+  if (result == DHT_DECODE_CORRECTED) {
+    _lastcorrected = true;
+    _corrections++;
+  }
+  _lastresult = result == DHT_DECODE_OK || result == DHT_DECODE_CORRECTED;
+  return _lastresult;
+}
+
+// Send the start signal and turn the captured edges into the 80 low/high pulse
+// lengths (in nanoseconds) of the 40 data bits.
+bool DHT_Linux::capture(uint32_t* pulses) {
+  if (!_source.start(dhtStartPulse(_type))) {
+    return false;
+  }
+
+  // The reply takes about 5ms.  Collect edges until the line stays quiet.
+  dht_edge_t edges[DHT_LINUX_MAX_EDGES];
+  int count = 0;
+  while (count < DHT_LINUX_MAX_EDGES) {
+    int n = _source.readEdges(edges + count, DHT_LINUX_MAX_EDGES - count,
+                              QUIET_USEC);
+    if (n < 0) {
+      _source.stop();
+      return false;
+    }
+    if (n == 0) {
+      break;
+    }
+    count += n;
+  }
+  _source.stop();
+
+  // Work back from the end of the transmission, which is less likely to be
+  // clipped than its start: the last bit's high pulse ends with a falling
+  // edge, optionally followed by the rising edge of the final release.  The
+  // 80 edges before that alternate falling (start of a bit's low pulse) and
+  // rising (start of its high pulse).
+  int end = count - 1;
+  while (end >= 0 && edges[end].rising) {
+    end--;
+  }
+  if (end < 80) {
+    return false;
+  }
+  const dht_edge_t* bits = edges + end - 80;
+  for (int i = 0; i <= 80; i++) {
+    if (bits[i].rising != (i % 2 == 1)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < 80; i++) {
+    pulses[i] = (uint32_t)(bits[i + 1].timestamp - bits[i].timestamp);
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*!
+ *  @file DHT_Linux.h
+ *
+ *  Linux backend for the DHT series of temperature/humidity sensors.
+ *
+ *  Instead of busy polling the data line, the start pulse is driven through
+ *  the GPIO character device (/dev/gpiochipN, uAPI v2 as used by libgpiod v2)
+ *  and the sensor's reply is captured as kernel timestamped edge events.
+ *  Edges are read in batches once the start pulse is released and decoded
+ *  with the same bit decoder as the Arduino class, so a read survives being
+ *  preempted and uses almost no CPU.
+ *
+ *  Only available when building for Linux outside of the Arduino IDE.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  Written by Adafruit Industries.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_LINUX_H
+#define DHT_LINUX_H
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "DHT_Frame.h"
+
+#define DHT_LINUX_MAX_EDGES 128 /**< Edges buffered for one transmission */
+
+/*!
+ *  @brief  One level change of the data line
+ */
+typedef struct {
+  uint64_t timestamp; /**< Kernel timestamp in nanoseconds */
+  bool rising;        /**< true for a low to high transition */
+} dht_edge_t;
+
+/*!
+ *  @brief  Interface to a source of data line edges.  Implemented by
+ *          DHT_GpioEdgeSource for real hardware; a fake implementation can
+ *          replay recorded edges in tests, see extras/test/test_linux.cpp.
+ */
+class DHT_EdgeSource {
+ public:
+  virtual ~DHT_EdgeSource() {}
+  /*!
+   *  @brief  Acquire the data line and leave it pulled up
+   *  @return true on success
+   */
+  virtual bool begin() = 0;
+  /*!
+   *  @brief  Send the start signal and begin capturing edges
+   *  @param  usec
+   *          time in microseconds to hold the data line low
+   *  @return true on success
+   */
+  virtual bool start(uint32_t usec) = 0;
+  /*!
+   *  @brief  Read the edges captured so far
+   *  @param  edges
+   *          receives up to max edges in the order they occurred
+   *  @param  max
+   *          capacity of edges
+   *  @param  usec
+   *          time in microseconds to wait for the first edge
+   *  @return number of edges read, 0 on timeout or -1 if edges were lost
+   */
+  virtual int readEdges(dht_edge_t* edges, int max, uint32_t usec) = 0;
+  /*!
+   *  @brief  Stop capturing edges and leave the data line pulled up
+   */
+  virtual void stop() = 0;
+};
+
+/*!
+ *  @brief  Edge source backed by a Linux GPIO character device line
+ */
+class DHT_GpioEdgeSource : public DHT_EdgeSource {
+ public:
+  DHT_GpioEdgeSource(const char* chip, uint32_t line);
+  ~DHT_GpioEdgeSource();
+  bool begin();
+  bool start(uint32_t usec);
+  int readEdges(dht_edge_t* edges, int max, uint32_t usec);
+  void stop();
+
+ private:
+  const char* _chip;
+  uint32_t _line;
+  int _fd;         // Line request file descriptor
+  uint32_t _seqno; // line_seqno expected for the next edge event
+
+  bool configure(uint64_t flags);
+};
+
+/*!
+ *  @brief  Class that stores state and functions for a DHT on Linux
+ */
+class DHT_Linux {
+ public:
+  DHT_Linux(DHT_EdgeSource& source, uint8_t type);
+  bool begin();
+  float readTemperature(bool S = false, bool force = false);
+  float readHumidity(bool force = false);
+  bool read(bool force = false);
+  bool readRaw(uint8_t* frame, bool force = false);
+  void setErrorCorrection(bool enable);
+  bool lastReadCorrected();
+  uint16_t correctedReadCount();
+
+ private:
+  DHT_EdgeSource& _source;
+  uint8_t data[5];
+  uint8_t _type;
+  bool _lastresult;
+  bool _correct;       // Try to repair frames that fail the checksum
+  bool _lastcorrected; // The last frame was repaired
+  uint16_t _corrections;
+  uint32_t _lastreadtime;
+
+  bool capture(uint32_t* pulses);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,266 @@
+/*!
+ *  @file DHT_Log.cpp
+ *
+ *  Compact streaming binary log format for raw DHT frames.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Log.h"
+
+#define SMALL_DELTA_ESCAPE 7 /**< 3 bit delta field value: varint follows */
+#define INTERVAL_CHANGED 0x40 /**< Delta header flag: interval change follows */
+
+// Map signed values to unsigned ones so small magnitudes of either sign stay
+// small: 0, -1, 1, -2, 2, ... become 0, 1, 2, 3, 4, ...
+static uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Write value 7 bits at a time, least significant group first, with the top
+// bit of each byte set when more bytes follow.
+static uint8_t putVarint(uint8_t* out, uint32_t value) {
+  uint8_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = (uint8_t)value | 0x80;
+    value >>= 7;
+  }
+  out[n++] = (uint8_t)value;
+  return n;
+}
+
+// Read a varint, returning the number of bytes used or 0 if it is truncated
+// or longer than 5 bytes.
+static uint8_t getVarint(const uint8_t* in, size_t len, uint32_t* value) {
+  uint32_t result = 0;
+  for (uint8_t n = 0; n < 5 && n < len; n++) {
+    result |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+    if (!(in[n] & 0x80)) {
+      *value = result;
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+/*!
+ *  @brief  Instantiates a new DHT_LogEncoder class
+ *  @param  keyframeInterval
+ *          number of records between keyframes (at least 1)
+ */
+DHT_LogEncoder::DHT_LogEncoder(uint16_t keyframeInterval) {
+  _keyframeInterval = keyframeInterval ? keyframeInterval : 1;
+  reset();
+}
+
+/*!
+ *  @brief  Make the next record a keyframe, e.g. when starting a new file
+ */
+void DHT_LogEncoder::reset() {
+  _sinceKeyframe = _keyframeInterval;
+  _humidity = _temperature = 0;
+  _timestamp = _interval = 0;
+}
+
+/*!
+ *  @brief  Encode one frame
+ *  @param  frame
+ *          raw 5 byte frame as read from the sensor
+ *  @param  timestamp
+ *          sample time, usually millis()
+ *  @param  out
+ *          buffer of at least DHT_LOG_MAX_RECORD bytes to append to the log
+ *  @return number of bytes written to out
+ */
+uint8_t DHT_LogEncoder::encode(const uint8_t* frame, uint32_t timestamp,
+                               uint8_t* out) {
+  uint16_t humidity = ((uint16_t)frame[0] << 8) | frame[1];
+  uint16_t temperature = ((uint16_t)frame[2] << 8) | frame[3];
+  uint32_t interval = timestamp - _timestamp;
+  uint8_t n;
+
+  if (_sinceKeyframe >= _keyframeInterval) {
+    // Keep the interval of the previous record so the samples that follow a
+    // periodic keyframe still encode without an interval change.
+    out[0] = DHT_LOG_KEYFRAME;
+    n = 1;
+    n += putVarint(out + n, timestamp);
+    n += putVarint(out + n, _interval);
+    out[n++] = frame[0];
+    out[n++] = frame[1];
+    out[n++] = frame[2];
+    out[n++] = frame[3];
+    _sinceKeyframe = 0;
+  } else {
+    uint32_t humidityDelta = zigzag((int16_t)(humidity - _humidity));
+    uint32_t temperatureDelta = zigzag((int16_t)(temperature - _temperature));
+    uint8_t header = 0;
+    n = 1;
+    if (interval != _interval) {
+      header |= INTERVAL_CHANGED;
+      n += putVarint(out + n, zigzag((int32_t)(interval - _interval)));
+    }
+    if (humidityDelta < SMALL_DELTA_ESCAPE) {
+      header |= humidityDelta << 3;
+    } else {
+      header |= SMALL_DELTA_ESCAPE << 3;
+      n += putVarint(out + n, humidityDelta);
+    }
+    if (temperatureDelta < SMALL_DELTA_ESCAPE) {
+      header |= temperatureDelta;
+    } else {
+      header |= SMALL_DELTA_ESCAPE;
+      n += putVarint(out + n, temperatureDelta);
+    }
+    out[0] = header;
+    _interval = interval;
+  }
+
+  _sinceKeyframe++;
+  _humidity = humidity;
+  _temperature = temperature;
+  _timestamp = timestamp;
+  return n;
+}
+
+/*!
+ *  @brief  Instantiates a new DHT_LogDecoder class
+ */
+DHT_LogDecoder::DHT_LogDecoder() {
+  reset();
+}
+
+/*!
+ *  @brief  Forget decoder state, e.g. when starting on a new log.  Records
+ *          before the next keyframe are rejected.
+ */
+void DHT_LogDecoder::reset() {
+  _synced = false;
+  _humidity = _temperature = 0;
+  _timestamp = _interval = 0;
+}
+
+/*!
+ *  @brief  Decode one record
+ *  @param  in
+ *          encoded log bytes starting at a record boundary
+ *  @param  len
+ *          number of bytes available in in
+ *  @param  record
+ *          filled with the decoded record on success
+ *  @return number of bytes consumed, 0 if the record is incomplete or -1 if
+ *          the data is corrupt or no keyframe has been seen yet
+ */
+int DHT_LogDecoder::decode(const uint8_t* in, size_t len,
+                           dht_log_record_t* record) {
+  if (len == 0) {
+    return 0;
+  }
+  uint8_t header = in[0];
+  size_t n = 1;
+  uint8_t used;
+  uint32_t value;
+
+  if (header == DHT_LOG_KEYFRAME) {
+    uint32_t timestamp, interval;
+    if (!(used = getVarint(in + n, len - n, &timestamp))) {
+      return len - n >= 5 ? -1 : 0;
+    }
+    n += used;
+    if (!(used = getVarint(in + n, len - n, &interval))) {
+      return len - n >= 5 ? -1 : 0;
+    }
+    n += used;
+    if (len - n < 4) {
+      return 0;
+    }
+    _humidity = ((uint16_t)in[n] << 8) | in[n + 1];
+    _temperature = ((uint16_t)in[n + 2] << 8) | in[n + 3];
+    n += 4;
+    _timestamp = timestamp;
+    _interval = interval;
+    _synced = true;
+  } else if (header & DHT_LOG_KEYFRAME || !_synced) {
+    return -1;
+  } else {
+    uint32_t interval = _interval;
+    uint16_t humidity = _humidity, temperature = _temperature;
+    if (header & INTERVAL_CHANGED) {
+      if (!(used = getVarint(in + n, len - n, &value))) {
+        return len - n >= 5 ? -1 : 0;
+      }
+      n += used;
+      interval += unzigzag(value);
+    }
+    value = (header >> 3) & 0x07;
+    if (value == SMALL_DELTA_ESCAPE) {
+      if (!(used = getVarint(in + n, len - n, &value))) {
+        return len - n >= 5 ? -1 : 0;
+      }
+      n += used;
+    }
+    humidity += unzigzag(value);
+    value = header & 0x07;
+    if (value == SMALL_DELTA_ESCAPE) {
+      if (!(used = getVarint(in + n, len - n, &value))) {
+        return len - n >= 5 ? -1 : 0;
+      }
+      n += used;
+    }
+    temperature += unzigzag(value);
+    _interval = interval;
+    _timestamp += interval;
+    _humidity = humidity;
+    _temperature = temperature;
+  }
+
+  record->timestamp = _timestamp;
+  record->data[0] = _humidity >> 8;
+  record->data[1] = _humidity & 0xFF;
+  record->data[2] = _temperature >> 8;
+  record->data[3] = _temperature & 0xFF;
+  record->data[4] =
+      record->data[0] + record->data[1] + record->data[2] + record->data[3];
+  return n;
+}
+
+/*!
+ *  @brief  Decode a buffer of records in bulk
+ *  @param  in
+ *          encoded log bytes starting at a record boundary
+ *  @param  len
+ *          number of bytes available in in
+ *  @param  records
+ *          filled with the decoded records
+ *  @param  maxRecords
+ *          capacity of records
+ *  @param  consumed
+ *          optionally set to the number of bytes decoded, so the caller can
+ *          keep an incomplete trailing record for the next call
+ *  @return number of records decoded; decoding stops early at corrupt data
+ */
+size_t DHT_LogDecoder::decodeAll(const uint8_t* in, size_t len,
+                                 dht_log_record_t* records, size_t maxRecords,
+                                 size_t* consumed) {
+  size_t count = 0, offset = 0;
+  while (count < maxRecords) {
+    int used = decode(in + offset, len - offset, &records[count]);
+    if (used <= 0) {
+      break;
+    }
+    offset += used;
+    count++;
+  }
+  if (consumed) {
+    *consumed = offset;
+  }
+  return count;
+}
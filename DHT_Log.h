@@ -0,0 +1,85 @@
+/*!
+ *  @file DHT_Log.h
+ *
+ *  Compact streaming binary log format for raw DHT frames.
+ *
+ *  Each record is either a keyframe, which stores the timestamp, the sample
+ *  interval and the 4 data bytes of a frame verbatim, or a delta record whose
+ *  first byte packs small humidity and temperature changes and whether the
+ *  sample interval changed:
+ *
+ *    keyframe: 0x80, varint timestamp, varint interval, data[0..3]
+ *    delta:    0b0tHHHTTT [, zigzag varint interval change] [, zigzag varint
+ *              humidity delta if HHH == 7] [, zigzag varint temperature delta
+ *              if TTT == 7]
+ *
+ *  HHH/TTT hold the zigzag encoded change of the 16 bit humidity (data[0..1])
+ *  and temperature (data[2..3]) words when it is below 7.  A 32 bit varint
+ *  takes up to 5 bytes, so keyframes are at most 1 + 5 + 5 + 4 = 15 bytes and
+ *  delta records at most 1 + 5 + 3 + 3 = 12 bytes.  The checksum byte
+ *  is not stored, only valid frames should be logged and decoding restores it.
+ *  Records only depend on earlier records, so a log can be appended to without
+ *  rewriting; every encoder starts with a keyframe and repeats one every
+ *  keyframeInterval records so a decoder can pick up from there.
+ *
+ *  This file has no Arduino dependencies so logs can be decoded on a host.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  Written by Adafruit Industries.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_LOG_H
+#define DHT_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DHT_LOG_MAX_RECORD 15 /**< Largest encoded record in bytes */
+#define DHT_LOG_KEYFRAME 0x80 /**< First byte of a keyframe record */
+
+/*!
+ *  @brief  One decoded log record
+ */
+typedef struct {
+  uint32_t timestamp; /**< Timestamp passed to the encoder, usually millis() */
+  uint8_t data[5];    /**< Raw sensor frame including the checksum byte */
+} dht_log_record_t;
+
+/*!
+ *  @brief  Class that encodes raw DHT frames into log records
+ */
+class DHT_LogEncoder {
+ public:
+  DHT_LogEncoder(uint16_t keyframeInterval = 256);
+  uint8_t encode(const uint8_t* frame, uint32_t timestamp, uint8_t* out);
+  void reset();
+
+ private:
+  uint16_t _keyframeInterval, _sinceKeyframe;
+  uint16_t _humidity, _temperature;
+  uint32_t _timestamp, _interval;
+};
+
+/*!
+ *  @brief  Class that decodes log records back into raw DHT frames
+ */
+class DHT_LogDecoder {
+ public:
+  DHT_LogDecoder();
+  int decode(const uint8_t* in, size_t len, dht_log_record_t* record);
+  size_t decodeAll(const uint8_t* in, size_t len, dht_log_record_t* records,
+                   size_t maxRecords, size_t* consumed = NULL);
+  void reset();
+
+ private:
+  bool _synced; // A keyframe has been decoded
+  uint16_t _humidity, _temperature;
+  uint32_t _timestamp, _interval;
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*!
+ *  @file DHT_Mux.cpp
+ *
+ *  Driver for many DHT sensors sharing one data pin through an analog
+ *  multiplexer.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Mux.h"
+
+/*!
+ *  @brief  Instantiates a new DHT_Mux class
+ *  @param  pin
+ *          pin number the mux's common pin is connected to
+ *  @param  selectPins
+ *          pin numbers of the mux's select lines, least significant first
+ *  @param  selectCount
+ *          number of select lines (up to 4), the mux addresses
+ *          2^selectCount channels
+ *  @param  type
+ *          type of sensor on every channel, see setType() for mixed types
+ *  @param  settleTime
+ *          time in microseconds to pull up the data line after switching
+ *          channels, before the start signal is sent
+ */
+DHT_Mux::DHT_Mux(uint8_t pin, const uint8_t* selectPins, uint8_t selectCount,
+                 uint8_t type, uint16_t settleTime)
+    : _dht(pin, type) {
+  if (selectCount > DHT_MUX_MAX_SELECT) {
+    selectCount = DHT_MUX_MAX_SELECT;
+  }
+  memcpy(_select, selectPins, selectCount);
+  _selectCount = selectCount;
+  _settleTime = settleTime;
+  _channel = 0;
+  _valid = 0;
+  _corrected = 0;
+  memset(_types, type, sizeof(_types));
+  memset(data, 0, sizeof(data));
+}
+
+/*!
+ *  @brief  Setup the select and data pins and set pull timings
+ *  @param  usec
+ *          Optionally pass pull-up time (in microseconds) before DHT reading
+ *          starts. Default is 55 (see function declaration in DHT_Mux.h).
+ */
+void DHT_Mux::begin(uint8_t usec) {
+  for (uint8_t i = 0; i < _selectCount; i++) {
+    pinMode(_select[i], OUTPUT);
+    digitalWrite(_select[i], LOW);
+  }
+  _channel = 0;
+  _dht.begin(usec);
+  // Using this value makes sure that millis() - lastreadtime will be
+  // >= DHT_MIN_INTERVAL right away. Note that this assignment wraps
+  // around, but so will the subtraction.
+  _lastreadtime = millis() - DHT_MIN_INTERVAL;
+}
+
+/*!
+ *  @brief  Set the type of the sensor on one channel
+ *  @param  channel
+ *          mux channel
+ *  @param  type
+ *          type of sensor
+ */
+void DHT_Mux::setType(uint8_t channel, uint8_t type) {
+  if (channel < DHT_MUX_MAX_CHANNELS) {
+    _types[channel] = type;
+  }
+}
+
+/*!
+ *  @brief  Number of channels addressed by the select lines
+ *  @return 2^selectCount
+ */
+uint8_t DHT_Mux::channels() {
+  return 1 << _selectCount;
+}
+
+/*!
+ *  @brief  Read every channel or return the results of the last scan from
+ *          less than two seconds ago.
+ *  @param  force
+ *          true if using force mode
+ *  @return number of channels that delivered a valid frame
+ */
+uint8_t DHT_Mux::scan(bool force) {
+  uint8_t count = channels();
+  uint32_t currenttime = millis();
+  if (force || ((currenttime - _lastreadtime) >= DHT_MIN_INTERVAL)) {
+    _lastreadtime = currenttime;
+    _valid = 0;
+    _corrected = 0;
+
+    uint32_t cycles[80];
+    bool captured = false;
+    uint8_t previous = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      // Gray code order: consecutive channels differ in one select line.
+      uint8_t channel = i ^ (i >> 1);
+      select(channel);
+      uint32_t switched = micros();
+
+#if defined(ESP8266)
+      yield(); // Handle WiFi / reset software watchdog
+#endif
+
+      // The pull-up settles the newly selected channel while the previous
+      // one is decoded.
+      if (i > 0) {
+        decode(previous, cycles, captured);
+      }
+      uint16_t startPulse = dhtStartPulse(_types[channel]);
+      while (micros() - switched < _settleTime) {
+      }
+
+      _dht.startSignal(startPulse);
+      captured = _dht.capturePulses(cycles);
+      previous = channel;
+    }
+    decode(previous, cycles, captured);
+  }
+
+  uint8_t valid = 0;
+  for (uint8_t channel = 0; channel < count; channel++) {
+    if (_valid & (1 << channel)) {
+      valid++;
+    }
+  }
+  return valid;
+}
+
+/*!
+ *  @brief  Read one channel, scanning all of them if the last scan is more
+ *          than two seconds old
+ *  @param  channel
+ *          mux channel
+ *  @param  force
+ *          true if using force mode
+ *  @return true if the channel delivered a valid frame
+ */
+bool DHT_Mux::read(uint8_t channel, bool force) {
+  scan(force);
+  return channel < channels() && (_valid & (1 << channel));
+}
+
+/*!
+ *  @brief  Read the raw 5 byte frame of one channel
+ *  @param  channel
+ *          mux channel
+ *  @param  frame
+ *          buffer of 5 bytes that receives data[0..4] on success
+ *  @param  force
+ *          true if using force mode
+ *  @return true if the frame is valid
+ */
+bool DHT_Mux::readRaw(uint8_t channel, uint8_t* frame, bool force) {
+  if (!read(channel, force)) {
+    return false;
+  }
+  memcpy(frame, data[channel], sizeof(data[channel]));
+  return true;
+}
+
+/*!
+ *  @brief  Read temperature of one channel
+ *  @param  channel
+ *          mux channel
+ *  @param  S
+ *          Scale. Boolean value:
+ *					- true = Fahrenheit
+ *					- false = Celcius
+ *  @param  force
+ *          true if in force mode
+ *	@return Temperature value in selected scale
+ */
+float DHT_Mux::readTemperature(uint8_t channel, bool S, bool force) {
+  float f = NAN;
+
+  if (read(channel, force)) {
+    f = dhtFrameTemperature(_types[channel], data[channel]);
+    if (S) {
+      f = _dht.convertCtoF(f);
+    }
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Read humidity of one channel
+ *  @param  channel
+ *          mux channel
+ *  @param  force
+ *          force read mode
+ *	@return float value - humidity in percent
+ */
+float DHT_Mux::readHumidity(uint8_t channel, bool force) {
+  float f = NAN;
+  if (read(channel, force)) {
+    f = dhtFrameHumidity(_types[channel], data[channel]);
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Enable or disable single bit error correction on every
+ *          channel, see dhtDecodePulses().  Disabled by default.
+ *  @param  enable
+ *          true to enable error correction
+ */
+void DHT_Mux::setErrorCorrection(bool enable) {
+  _dht.setErrorCorrection(enable);
+}
+
+/*!
+ *  @brief  Check whether the last frame read from one channel was corrected
+ *  @param  channel
+ *          mux channel
+ *  @return true if the channel's last frame failed the checksum and was
+ *          repaired
+ */
+bool DHT_Mux::lastReadCorrected(uint8_t channel) {
+  return channel < channels() && (_corrected & (1 << channel));
+}
+
+/*!
+ *  @brief  Number of frames repaired by error correction on all channels
+ *          since startup
+ *  @return corrected frame count (wraps around at 65535)
+ */
+uint16_t DHT_Mux::correctedReadCount() {
+  return _dht.correctedReadCount();
+}
+
+// Address channel, only writing the select lines that change.
+void DHT_Mux::select(uint8_t channel) {
+  uint8_t changed = channel ^ _channel;
+  for (uint8_t i = 0; i < _selectCount; i++) {
+    if (changed & (1 << i)) {
+      digitalWrite(_select[i], (channel >> i) & 1 ? HIGH : LOW);
+    }
+  }
+  _channel = channel;
+}
+
+// Turn the pulses captured from channel into its frame.
+void DHT_Mux::decode(uint8_t channel, const uint32_t* cycles, bool captured) {
+  if (!captured) {
+    memset(data[channel], 0, sizeof(data[channel]));
+    return;
+  }
+  dht_decode_t result = dhtDecodePulses(cycles, data[channel], _dht._correct);
+  if (result == DHT_DECODE_CORRECTED) {
+    _corrected |= 1 << channel;
+    _dht._corrections++;
+  }
+  if (result == DHT_DECODE_OK || result == DHT_DECODE_CORRECTED) {
+    _valid |= 1 << channel;
+  }
+}
@@ -0,0 +1,75 @@
+/*!
+ *  @file DHT_Mux.h
+ *
+ *  Driver for many DHT sensors sharing one data pin through an analog
+ *  multiplexer such as the 74HC4051 (8 channels) or CD74HC4067 (16
+ *  channels).  The mux's common pin is wired to the data pin, its select
+ *  lines to up to four digital pins and its enable pin is held low.
+ *
+ *  Every channel needs its own pull-up resistor (e.g. 10k to VCC) on the
+ *  sensor side of the mux.  The MCU's pull-up only reaches the selected
+ *  channel, so a deselected channel would float, and noise on a floating
+ *  line can look like a start signal to its sensor, which then answers while
+ *  another channel is being read or is still busy when it is selected.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  Written by Adafruit Industries.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_MUX_H
+#define DHT_MUX_H
+
+#include "DHT.h"
+
+#define DHT_MUX_MAX_SELECT 4    /**< Select lines of a 16 channel mux */
+#define DHT_MUX_MAX_CHANNELS 16 /**< Channels of a 16 channel mux */
+
+/*!
+ *  @brief  Class that stores state and functions for DHT sensors behind an
+ *          analog multiplexer.
+ *
+ *  scan() reads every channel with the same start/capture/decode sequence as
+ *  the DHT class.  Channels are visited in Gray code order so each step
+ *  toggles a single select line, and the pulses captured from one channel
+ *  are decoded while the line settles on the next one, so the decode and
+ *  checksum work adds no time to a scan as long as it is shorter than the
+ *  settle time.
+ */
+class DHT_Mux {
+ public:
+  DHT_Mux(uint8_t pin, const uint8_t* selectPins, uint8_t selectCount,
+          uint8_t type, uint16_t settleTime = 1000);
+  void begin(uint8_t usec = 55);
+  void setType(uint8_t channel, uint8_t type);
+  uint8_t channels();
+  uint8_t scan(bool force = false);
+  bool read(uint8_t channel, bool force = false);
+  bool readRaw(uint8_t channel, uint8_t* frame, bool force = false);
+  float readTemperature(uint8_t channel, bool S = false, bool force = false);
+  float readHumidity(uint8_t channel, bool force = false);
+  void setErrorCorrection(bool enable);
+  bool lastReadCorrected(uint8_t channel);
+  uint16_t correctedReadCount();
+
+ private:
+  DHT _dht; // Drives the shared data pin
+  uint32_t _lastreadtime;
+  uint16_t _valid;      // Bit n is set if channel n delivered a valid frame
+  uint16_t _corrected;  // Bit n is set if channel n's frame was repaired
+  uint16_t _settleTime; // Time (in usec) to pull up a newly selected channel
+  uint8_t _select[DHT_MUX_MAX_SELECT];
+  uint8_t _selectCount;
+  uint8_t _channel; // Channel the select lines currently address
+  uint8_t _types[DHT_MUX_MAX_CHANNELS];
+  uint8_t data[DHT_MUX_MAX_CHANNELS][5];
+
+  void select(uint8_t channel);
+  void decode(uint8_t channel, const uint32_t* cycles, bool captured);
+};
+
+#endif
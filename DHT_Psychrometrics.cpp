@@ -0,0 +1,193 @@
+/*!
+ *  @file DHT_Psychrometrics.cpp
+ *
+ *  Derived psychrometric values (dew point, absolute humidity and vapour
+ *  pressure deficit) for the DHT series of temperature/humidity sensors.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#include "DHT_Psychrometrics.h"
+
+#define MAGNUS_A 17.62f  /**< Magnus coefficient (dimensionless) */
+#define MAGNUS_B 243.12f /**< Magnus coefficient in degrees Celsius */
+#define MAGNUS_C 6.112f  /**< Saturation vapour pressure at 0 C in hPa */
+
+// 2^k for the exponents the approximations below produce, built directly
+// from the IEEE 754 bit pattern instead of calling ldexpf().
+static float powerOfTwo(int k) {
+  uint32_t bits = (uint32_t)(k + 127) << 23;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+// exp(x) for the range the Magnus formula needs.  x is split into k * ln(2)
+// plus a remainder |r| <= ln(2) / 2, exp(r) is a 5th order Taylor polynomial
+// (relative error below 2.5e-6) and the result is scaled back by 2^k.
+static float fastExp(float x) {
+  float y = x * 1.44269504f;
+  int k = (int)(y < 0 ? y - 0.5f : y + 0.5f);
+  float r = x - k * 0.69314718f;
+  float p = 0.04166667f + r * 0.00833333f;
+  p = 0.16666667f + r * p;
+  p = 0.5f + r * p;
+  p = 1.0f + r * p;
+  p = 1.0f + r * p;
+  return p * powerOfTwo(k);
+}
+
+// log(x) for normal x > 0.  The mantissa is normalised to [sqrt(0.5),
+// sqrt(2)) and log(m) = 2 * atanh(t) with t = (m - 1) / (m + 1), |t| < 0.172,
+// is summed up to t^5 (absolute error below 1.5e-6).
+static float fastLog(float x) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  int e = (int)(bits >> 23) - 127;
+  float m = x * powerOfTwo(-e);
+  if (m > 1.41421356f) {
+    m *= 0.5f;
+    e++;
+  }
+  float t = (m - 1.0f) / (m + 1.0f);
+  float t2 = t * t;
+  return 2.0f * t * (1.0f + t2 * (0.33333333f + t2 * 0.2f)) + e * 0.69314718f;
+}
+
+/*!
+ *  @brief  Instantiates a new DHT_Psychrometrics class
+ *  @param  dht
+ *          sensor the values are derived from
+ *  @param  fast
+ *          true to use the polynomial exp/log approximations (default), false
+ *          to use the C library exp() and log()
+ */
+DHT_Psychrometrics::DHT_Psychrometrics(DHT& dht, bool fast)
+    : _dht(dht), _fast(fast), _valid(false), _frametime(0) {}
+
+/*!
+ *  @brief  Read all derived values for the current frame
+ *  @param  values
+ *          filled with the derived values on success
+ *  @param  force
+ *          true if in force mode
+ *  @return true if the sensor delivered a valid frame
+ */
+bool DHT_Psychrometrics::read(dht_psychrometrics_t* values, bool force) {
+  if (!update(force)) {
+    return false;
+  }
+  *values = _values;
+  return true;
+}
+
+/*!
+ *  @brief  Dew point for the current frame
+ *  @param  isFahrenheit
+ *          true for Fahrenheit, false for Celcius (default false)
+ *  @param  force
+ *          true if in force mode
+ *  @return dew point in the selected scale, NAN if the read failed
+ */
+float DHT_Psychrometrics::dewPoint(bool isFahrenheit, bool force) {
+  if (!update(force)) {
+    return NAN;
+  }
+  return isFahrenheit ? _dht.convertCtoF(_values.dewPoint) : _values.dewPoint;
+}
+
+/*!
+ *  @brief  Absolute humidity for the current frame
+ *  @param  force
+ *          true if in force mode
+ *  @return absolute humidity in g/m^3, NAN if the read failed
+ */
+float DHT_Psychrometrics::absoluteHumidity(bool force) {
+  return update(force) ? _values.absoluteHumidity : NAN;
+}
+
+/*!
+ *  @brief  Vapour pressure deficit for the current frame
+ *  @param  force
+ *          true if in force mode
+ *  @return vapour pressure deficit in kPa, NAN if the read failed
+ */
+float DHT_Psychrometrics::vaporPressureDeficit(bool force) {
+  return update(force) ? _values.vaporPressureDeficit : NAN;
+}
+
+/*!
+ *  @brief  Compute derived values for one sample
+ *  @param  temperature
+ *          temperature in Celcius
+ *  @param  percentHumidity
+ *          relative humidity in percent
+ *  @param  values
+ *          filled with the derived values
+ *  @param  fast
+ *          true to use the polynomial exp/log approximations
+ */
+void DHT_Psychrometrics::compute(float temperature, float percentHumidity,
+                                 dht_psychrometrics_t* values, bool fast) {
+  // Saturation vapour pressure (hPa) and its Magnus exponent.
+  float gamma = MAGNUS_A * temperature / (MAGNUS_B + temperature);
+  float saturation = MAGNUS_C * (fast ? fastExp(gamma) : exp(gamma));
+  float rh = percentHumidity * 0.01f;
+  float vapour = saturation * rh;
+
+  // Dew point: invert the Magnus formula for the actual vapour pressure.  It
+  // is undefined for perfectly dry air.
+  if (rh > 0) {
+    gamma += fast ? fastLog(rh) : log(rh);
+    values->dewPoint = MAGNUS_B * gamma / (MAGNUS_A - gamma);
+  } else {
+    values->dewPoint = NAN;
+  }
+  // Ideal gas law for water vapour: 100 / R_v * 1000 = 216.7 g K / (m^3 hPa).
+  values->absoluteHumidity = 216.7f * vapour / (temperature + 273.15f);
+  values->vaporPressureDeficit = (saturation - vapour) * 0.1f;
+}
+
+/*!
+ *  @brief  Compute derived values for an array of samples
+ *  @param  temperature
+ *          temperatures in Celcius
+ *  @param  percentHumidity
+ *          relative humidities in percent
+ *  @param  values
+ *          filled with count derived values
+ *  @param  count
+ *          number of samples
+ *  @param  fast
+ *          true to use the polynomial exp/log approximations
+ */
+void DHT_Psychrometrics::compute(const float* temperature,
+                                 const float* percentHumidity,
+                                 dht_psychrometrics_t* values, size_t count,
+                                 bool fast) {
+  for (size_t i = 0; i < count; i++) {
+    compute(temperature[i], percentHumidity[i], &values[i], fast);
+  }
+}
+
+// Make sure _values belong to the sensor's current frame.  read() returns
+// its cached result within the minimum interval, so a frame is new only when
+// the time of the last bus read has moved, and only then are temperature and
+// humidity converted and the derived values recomputed.
+bool DHT_Psychrometrics::update(bool force) {
+  if (!_dht.read(force)) {
+    _valid = false;
+    return false;
+  }
+  uint32_t frametime = _dht.lastReadTime();
+  if (!_valid || frametime != _frametime) {
+    compute(_dht.readTemperature(), _dht.readHumidity(), &_values, _fast);
+    _frametime = frametime;
+    _valid = true;
+  }
+  return true;
+}
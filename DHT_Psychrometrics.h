@@ -0,0 +1,74 @@
+/*!
+ *  @file DHT_Psychrometrics.h
+ *
+ *  Derived psychrometric values (dew point, absolute humidity and vapour
+ *  pressure deficit) for the DHT series of temperature/humidity sensors.
+ *
+ *  Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit andopen-source hardware by purchasing products
+ *  from Adafruit!
+ *
+ *  Written by Adafruit Industries.
+ *
+ *  MIT license, all text above must be included in any redistribution
+ */
+
+#ifndef DHT_PSYCHROMETRICS_H
+#define DHT_PSYCHROMETRICS_H
+
+#include "DHT.h"
+
+/*!
+ *  @brief  Psychrometric values derived from one temperature/humidity sample
+ */
+typedef struct {
+  float dewPoint;             /**< Dew point in degrees Celsius */
+  float absoluteHumidity;     /**< Absolute humidity in g/m^3 */
+  float vaporPressureDeficit; /**< Vapour pressure deficit in kPa */
+} dht_psychrometrics_t;
+
+/*!
+ *  @brief  Class that computes dew point, absolute humidity and vapour
+ *          pressure deficit for a DHT sensor and caches them per frame.
+ *
+ *  Values are computed lazily the first time they are requested after the
+ *  sensor delivers a new frame.  Repeated calls within the sensor's two
+ *  second caching window only check the time of the last read and copy the
+ *  cached values.
+ *
+ *  All values use the Magnus approximation of the saturation vapour pressure
+ *  over water with the Sonntag (1990) constants a = 17.62, b = 243.12 C.
+ *  The fast variant replaces exp()/log() with short range-reduced
+ *  polynomials; compared to the same formula evaluated in double precision
+ *  it stays within 0.0001 C dew point, 0.001 g/m^3 absolute humidity and
+ *  0.0001 kPa vapour pressure deficit over -40 C..80 C and 1..100 %RH.
+ *  It is meant for boards without a hardware FPU.  On x86-64 with glibc
+ *  extras/test/bench_psychrometrics measures it at about two thirds the
+ *  speed of the C library, so pass fast = false there.  Its gain on AVR has
+ *  not been measured.
+ */
+class DHT_Psychrometrics {
+ public:
+  DHT_Psychrometrics(DHT& dht, bool fast = true);
+  bool read(dht_psychrometrics_t* values, bool force = false);
+  float dewPoint(bool isFahrenheit = false, bool force = false);
+  float absoluteHumidity(bool force = false);
+  float vaporPressureDeficit(bool force = false);
+
+  static void compute(float temperature, float percentHumidity,
+                      dht_psychrometrics_t* values, bool fast = true);
+  static void compute(const float* temperature, const float* percentHumidity,
+                      dht_psychrometrics_t* values, size_t count,
+                      bool fast = true);
+
+ private:
+  DHT& _dht;
+  bool _fast;
+  bool _valid; // _values hold the frame read at _frametime
+  uint32_t _frametime;
+  dht_psychrometrics_t _values;
+
+  bool update(bool force);
+};
+
+#endif
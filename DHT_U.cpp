@@ -30,7 +30,6 @@
 DHT_Unified::DHT_Unified(uint8_t pin, uint8_t type, uint8_t count,
                          int32_t tempSensorId, int32_t humiditySensorId)
     : _dht(pin, type, count),
-      _type(type),
       _temp(this, tempSensorId),
       _humidity(this, humiditySensorId) {}
 
@@ -42,58 +41,104 @@ void DHT_Unified::begin() {
 }
 
 /*!
- *  @brief  Sets sensor name
- *  @param  sensor
- *          Sensor that will be set
+ *  @brief  Reads the sensor once and returns both readings as
+ *          sensors_event_t, sharing one timestamp.  Equivalent to calling
+ *          temperature().getEvent() and humidity().getEvent().
+ *  @param  temperature
+ *          receives the temperature event
+ *  @param  humidity
+ *          receives the humidity event
+ *  @return true if the sensor delivered a valid frame; the events are filled
+ *          (with NAN readings) either way
+ */
+bool DHT_Unified::getEvents(sensors_event_t* temperature,
+                            sensors_event_t* humidity) {
+  // Clear event definitions.
+  memset(temperature, 0, sizeof(sensors_event_t));
+  memset(humidity, 0, sizeof(sensors_event_t));
+  return fillEvents(temperature, humidity, millis());
+}
+
+/*!
+ *  @brief  Reads several sensors, one frame each, into a caller provided
+ *          array of events.  All events share one timestamp and the array is
+ *          cleared with a single memset.
+ *  @param  sensors
+ *          array of count sensors
+ *  @param  count
+ *          number of sensors
+ *  @param  events
+ *          array of 2 * count events that receives the temperature and
+ *          humidity event of sensors[i] at index 2 * i and 2 * i + 1
+ *  @return number of sensors that delivered a valid frame
  */
-void DHT_Unified::setName(sensor_t* sensor) {
-  switch (_type) {
-    case DHT11:
-      strncpy(sensor->name, "DHT11", sizeof(sensor->name) - 1);
-      break;
-    case DHT12:
-      strncpy(sensor->name, "DHT12", sizeof(sensor->name) - 1);
-      break;
-    case DHT21:
-      strncpy(sensor->name, "DHT21", sizeof(sensor->name) - 1);
-      break;
-    case DHT22:
-      strncpy(sensor->name, "DHT22", sizeof(sensor->name) - 1);
-      break;
-    default:
-      // TODO: Perhaps this should be an error?  However main DHT library
-      // doesn't enforce restrictions on the sensor type value.  Pick a generic
-      // name for now.
-      strncpy(sensor->name, "DHT?", sizeof(sensor->name) - 1);
-      break;
+uint8_t DHT_Unified::getEvents(DHT_Unified** sensors, uint8_t count,
+                               sensors_event_t* events) {
+  // Clear event definitions.
+  memset(events, 0, 2 * count * sizeof(sensors_event_t));
+  int32_t timestamp = millis();
+  uint8_t valid = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (sensors[i]->fillEvents(&events[2 * i], &events[2 * i + 1],
+                               timestamp)) {
+      valid++;
+    }
   }
-  sensor->name[sizeof(sensor->name) - 1] = 0;
+  return valid;
+}
+
+// Read one frame and populate a pair of already cleared events from it.
+bool DHT_Unified::fillEvents(sensors_event_t* temperature,
+                             sensors_event_t* humidity, int32_t timestamp) {
+  uint8_t frame[5];
+  bool valid = _dht.readRaw(frame);
+
+  temperature->version = sizeof(sensors_event_t);
+  temperature->sensor_id = _temp._id;
+  temperature->type = SENSOR_TYPE_AMBIENT_TEMPERATURE;
+  temperature->timestamp = timestamp;
+  temperature->temperature =
+      valid ? dhtFrameTemperature(_dht._type, frame) : NAN;
+
+  humidity->version = sizeof(sensors_event_t);
+  humidity->sensor_id = _humidity._id;
+  humidity->type = SENSOR_TYPE_RELATIVE_HUMIDITY;
+  humidity->timestamp = timestamp;
+  humidity->relative_humidity =
+      valid ? dhtFrameHumidity(_dht._type, frame) : NAN;
+
+  return valid;
 }
 
 /*!
- *  @brief  Sets Minimum Delay Value
+ *  @brief  Fills in the sensor_t fields shared by both sensors from the model
+ *          table
  *  @param  sensor
  *          Sensor that will be set
+ *  @param  id
+ *          Sensor id
+ *  @param  type
+ *          SENSOR_TYPE_AMBIENT_TEMPERATURE or SENSOR_TYPE_RELATIVE_HUMIDITY
+ *  @param  model
+ *          receives the model constants for the sensor type
  */
-void DHT_Unified::setMinDelay(sensor_t* sensor) {
-  switch (_type) {
-    case DHT11:
-      sensor->min_delay = 1000000L; // 1 second (in microseconds)
-      break;
-    case DHT12:
-      sensor->min_delay = 2000000L; // 2 second (in microseconds)
-      break;
-    case DHT21:
-      sensor->min_delay = 2000000L; // 2 seconds (in microseconds)
-      break;
-    case DHT22:
-      sensor->min_delay = 2000000L; // 2 seconds (in microseconds)
-      break;
-    default:
-      // Default to slowest sample rate in case of unknown type.
-      sensor->min_delay = 2000000L; // 2 seconds (in microseconds)
-      break;
-  }
+void DHT_Unified::setSensor(sensor_t* sensor, int32_t id, int32_t type,
+                            dht_model_t* model) {
+  // An unknown type gets a generic name, the slowest sample rate and zero
+  // ranges.  Main DHT library doesn't enforce restrictions on the sensor type
+  // value, so this is not an error.
+  dhtModel(_dht._type, model);
+  // Clear sensor definition.
+  memset(sensor, 0, sizeof(sensor_t));
+  // Set sensor name.
+  strncpy(sensor->name, model->name, sizeof(sensor->name) - 1);
+  sensor->name[sizeof(sensor->name) - 1] = 0;
+  // Set version and ID
+  sensor->version = DHT_SENSOR_VERSION;
+  sensor->sensor_id = id;
+  // Set type and characteristics.
+  sensor->type = type;
+  sensor->min_delay = model->minDelay * 1000000L; // seconds to microseconds
 }
 
 /*!
@@ -129,44 +174,11 @@ bool DHT_Unified::Temperature::getEvent(sensors_event_t* event) {
  *  @param  sensor
  */
 void DHT_Unified::Temperature::getSensor(sensor_t* sensor) {
-  // Clear sensor definition.
-  memset(sensor, 0, sizeof(sensor_t));
-  // Set sensor name.
-  _parent->setName(sensor);
-  // Set version and ID
-  sensor->version = DHT_SENSOR_VERSION;
-  sensor->sensor_id = _id;
-  // Set type and characteristics.
-  sensor->type = SENSOR_TYPE_AMBIENT_TEMPERATURE;
-  _parent->setMinDelay(sensor);
-  switch (_parent->_type) {
-    case DHT11:
-      sensor->max_value = 50.0F;
-      sensor->min_value = 0.0F;
-      sensor->resolution = 2.0F;
-      break;
-    case DHT12:
-      sensor->max_value = 60.0F;
-      sensor->min_value = -20.0F;
-      sensor->resolution = 0.5F;
-      break;
-    case DHT21:
-      sensor->max_value = 80.0F;
-      sensor->min_value = -40.0F;
-      sensor->resolution = 0.1F;
-      break;
-    case DHT22:
-      sensor->max_value = 125.0F;
-      sensor->min_value = -40.0F;
-      sensor->resolution = 0.1F;
-      break;
-    default:
-      // Unknown type, default to 0.
-      sensor->max_value = 0.0F;
-      sensor->min_value = 0.0F;
-      sensor->resolution = 0.0F;
-      break;
-  }
+  dht_model_t model;
+  _parent->setSensor(sensor, _id, SENSOR_TYPE_AMBIENT_TEMPERATURE, &model);
+  sensor->max_value = model.temperatureMax;
+  sensor->min_value = model.temperatureMin;
+  sensor->resolution = model.temperatureResolution;
 }
 
 /*!
@@ -202,42 +214,9 @@ bool DHT_Unified::Humidity::getEvent(sensors_event_t* event) {
  *  @param  sensor
  */
 void DHT_Unified::Humidity::getSensor(sensor_t* sensor) {
-  // Clear sensor definition.
-  memset(sensor, 0, sizeof(sensor_t));
-  // Set sensor name.
-  _parent->setName(sensor);
-  // Set version and ID
-  sensor->version = DHT_SENSOR_VERSION;
-  sensor->sensor_id = _id;
-  // Set type and characteristics.
-  sensor->type = SENSOR_TYPE_RELATIVE_HUMIDITY;
-  _parent->setMinDelay(sensor);
-  switch (_parent->_type) {
-    case DHT11:
-      sensor->max_value = 80.0F;
-      sensor->min_value = 20.0F;
-      sensor->resolution = 5.0F;
-      break;
-    case DHT12:
-      sensor->max_value = 95.0F;
-      sensor->min_value = 20.0F;
-      sensor->resolution = 5.0F;
-      break;
-    case DHT21:
-      sensor->max_value = 100.0F;
-      sensor->min_value = 0.0F;
-      sensor->resolution = 0.1F;
-      break;
-    case DHT22:
-      sensor->max_value = 100.0F;
-      sensor->min_value = 0.0F;
-      sensor->resolution = 0.1F;
-      break;
-    default:
-      // Unknown type, default to 0.
-      sensor->max_value = 0.0F;
-      sensor->min_value = 0.0F;
-      sensor->resolution = 0.0F;
-      break;
-  }
+  dht_model_t model;
+  _parent->setSensor(sensor, _id, SENSOR_TYPE_RELATIVE_HUMIDITY, &model);
+  sensor->max_value = model.humidityMax;
+  sensor->min_value = model.humidityMin;
+  sensor->resolution = model.humidityResolution;
 }
@@ -47,6 +47,9 @@ class DHT_Unified {
   DHT_Unified(uint8_t pin, uint8_t type, uint8_t count = 6,
               int32_t tempSensorId = -1, int32_t humiditySensorId = -1);
   void begin();
+  bool getEvents(sensors_event_t* temperature, sensors_event_t* humidity);
+  static uint8_t getEvents(DHT_Unified** sensors, uint8_t count,
+                           sensors_event_t* events);
 
   /*!
    *  @brief  Class that stores state and functions about Temperature
@@ -58,6 +61,7 @@ class DHT_Unified {
     void getSensor(sensor_t* sensor);
 
    private:
+    friend class DHT_Unified;
     DHT_Unified* _parent;
     int32_t _id;
   };
@@ -72,34 +76,36 @@ class DHT_Unified {
     void getSensor(sensor_t* sensor);
 
    private:
+    friend class DHT_Unified;
     DHT_Unified* _parent;
     int32_t _id;
   };
 
   /*!
    *  @brief  Returns temperature stored in _temp
-   *  @return Temperature value
+   *  @return Temperature sensor, by reference to avoid copying it
    */
-  Temperature temperature() {
+  Temperature& temperature() {
     return _temp;
   }
 
   /*!
    *  @brief  Returns humidity stored in _humidity
-   *  @return Humidity value
+   *  @return Humidity sensor, by reference to avoid copying it
    */
-  Humidity humidity() {
+  Humidity& humidity() {
     return _humidity;
   }
 
  private:
   DHT _dht;
-  uint8_t _type;
   Temperature _temp;
   Humidity _humidity;
 
-  void setName(sensor_t* sensor);
-  void setMinDelay(sensor_t* sensor);
+  void setSensor(sensor_t* sensor, int32_t id, int32_t type,
+                 dht_model_t* model);
+  bool fillEvents(sensors_event_t* temperature, sensors_event_t* humidity,
+                  int32_t timestamp);
 };
 
 #endif
@@ -0,0 +1,67 @@
+/*!
+ *  @file Adafruit_Sensor.h
+ *
+ *  The parts of the Adafruit Unified Sensor library used by DHT_U, laid out
+ *  like the original so event sizes match.
+ */
+
+#ifndef ADAFRUIT_SENSOR_H
+#define ADAFRUIT_SENSOR_H
+
+#include <stdint.h>
+
+#define SENSOR_TYPE_RELATIVE_HUMIDITY 12 /**< Relative humidity */
+#define SENSOR_TYPE_AMBIENT_TEMPERATURE 13 /**< Ambient temperature */
+
+/*!
+ *  @brief  Sensor event
+ */
+typedef struct {
+  int32_t version;   /**< Must be sizeof(sensors_event_t) */
+  int32_t sensor_id; /**< Unique sensor identifier */
+  int32_t type;      /**< Sensor type */
+  int32_t reserved0; /**< Reserved */
+  int32_t timestamp; /**< Time in milliseconds */
+  union {
+    float data[4];           /**< Raw data */
+    float temperature;       /**< Temperature in degrees Celcius */
+    float relative_humidity; /**< Relative humidity in percent */
+  };
+} sensors_event_t;
+
+/*!
+ *  @brief  Sensor details
+ */
+typedef struct {
+  char name[12];     /**< Sensor name */
+  int32_t version;   /**< Version of the hardware and driver */
+  int32_t sensor_id; /**< Unique sensor identifier */
+  int32_t type;      /**< Sensor type */
+  float max_value;   /**< Maximum value of this sensor's value */
+  float min_value;   /**< Minimum value of this sensor's value */
+  float resolution;  /**< Smallest difference between two values */
+  int32_t min_delay; /**< Minimum delay in microseconds between events */
+} sensor_t;
+
+/*!
+ *  @brief  Common sensor interface
+ */
+class Adafruit_Sensor {
+ public:
+  virtual ~Adafruit_Sensor() {}
+  /*!
+   *  @brief  Get the latest sensor event
+   *  @param  event
+   *          receives the event
+   *  @return true if the event is valid
+   */
+  virtual bool getEvent(sensors_event_t* event) = 0;
+  /*!
+   *  @brief  Get info about the sensor itself
+   *  @param  sensor
+   *          receives the sensor details
+   */
+  virtual void getSensor(sensor_t* sensor) = 0;
+};
+
+#endif
@@ -0,0 +1,177 @@
+/*!
+ *  @file Arduino.cpp
+ *
+ *  Simulated Arduino core and DHT sensors, see sim.h.
+ */
+
+#include "sim.h"
+
+sim_sensor_t simSensors[SIM_CHANNELS];
+sim_stats_t simStats;
+uint32_t simSettleTime;
+
+static double now;        // Virtual time in usec
+static uint8_t channel;   // Channel the select lines address
+static double switchedAt; // Time of the last channel switch
+static bool driving;      // The MCU holds the data line low
+static double lowSince;   // Start of the current start signal
+static int responder;     // Channel sending a frame, -1 if none
+static double responseAt; // Time the response started
+static double edges[84];  // Level changes relative to responseAt
+static int edgeCount;
+static int edgesPassed;   // Edges of the response the clock has passed
+
+/*!
+ *  @brief  Restart the clock at one second with one DHT22 on channel 0 and
+ *          nothing on the other channels, all sending clean frames
+ */
+void simReset() {
+  memset(simSensors, 0, sizeof(simSensors));
+  for (int i = 0; i < SIM_CHANNELS; i++) {
+    simSensors[i].marginalBit = -1;
+  }
+  simSensors[0].type = 22;
+  simSensors[0].temperature = 21.5;
+  simSensors[0].humidity = 45.2;
+  memset(&simStats, 0, sizeof(simStats));
+  simSettleTime = 300;
+  now = 1e6;
+  channel = 0;
+  switchedAt = 0;
+  driving = false;
+  responder = -1;
+}
+
+/*!
+ *  @brief  Advance the virtual clock
+ *  @param  usec
+ *          time to let pass in microseconds
+ */
+void simAdvance(double usec) {
+  now += usec;
+}
+
+/*!
+ *  @brief  Current virtual time
+ *  @return time in microseconds
+ */
+double simTime() {
+  return now;
+}
+
+// Frame a sensor sends for its current values.
+static void sensorFrame(const sim_sensor_t* sensor, uint8_t* frame) {
+  memset(frame, 0, 5);
+  if (sensor->type == 11) {
+    float temperature = sensor->temperature + 0.05F;
+    frame[0] = (uint8_t)(sensor->humidity + 0.5F);
+    frame[2] = (uint8_t)temperature;
+    frame[3] = (uint8_t)((temperature - frame[2]) * 10);
+  } else {
+    int humidity = lround(sensor->humidity * 10);
+    int temperature = lround(fabs(sensor->temperature) * 10);
+    frame[0] = humidity >> 8;
+    frame[1] = humidity & 0xFF;
+    frame[2] = (temperature >> 8) | (sensor->temperature < 0 ? 0x80 : 0);
+    frame[3] = temperature & 0xFF;
+  }
+  frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+}
+
+// Let the sensor on channel which answer a start signal: 80us low, 80us high,
+// then 40 bits of 50us low and 26us (0) or 70us (1) high, and a final 50us
+// low.  The sensor's marginal bit gets a 48us (1) or 52us (0) high instead.
+static void respond(uint8_t which) {
+  uint8_t frame[5];
+  sensorFrame(&simSensors[which], frame);
+  double t = 30;
+  edgeCount = 0;
+  edges[edgeCount++] = t;
+  t += 80;
+  edges[edgeCount++] = t;
+  t += 80;
+  for (int i = 0; i < 40; i++) {
+    edges[edgeCount++] = t;
+    t += 50;
+    edges[edgeCount++] = t;
+    bool bit = frame[i / 8] & (0x80 >> (i % 8));
+    if (i == simSensors[which].marginalBit) {
+      t += bit ? 48 : 52;
+    } else {
+      t += bit ? 70 : 26;
+    }
+  }
+  edges[edgeCount++] = t;
+  edges[edgeCount++] = t + 50;
+  responder = which;
+  responseAt = now;
+  edgesPassed = 0;
+  simStats.responses++;
+}
+
+uint32_t millis() {
+  return (uint32_t)(now / 1000);
+}
+
+uint32_t micros() {
+  now += 0.5;
+  return (uint32_t)now;
+}
+
+void delay(uint32_t ms) {
+  now += ms * 1000.0;
+}
+
+void delayMicroseconds(uint32_t usec) {
+  now += usec;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin != SIM_DATA_PIN) {
+    return;
+  }
+  if (mode == OUTPUT) {
+    // Outputs start low, as the digitalWrite(LOW) that follows makes sure.
+    driving = true;
+    lowSince = now;
+    responder = -1;
+    if (now - switchedAt < simSettleTime) {
+      simStats.unsettledStarts++;
+    }
+  } else if (driving) {
+    driving = false;
+    const sim_sensor_t* sensor = &simSensors[channel];
+    double needed = sensor->type == 11 || sensor->type == 12 ? 18000 : 1000;
+    if (sensor->type && now - lowSince >= needed) {
+      respond(channel);
+    }
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < SIM_SELECT_PIN || pin >= SIM_SELECT_PIN + 4) {
+    return;
+  }
+  uint8_t bit = 1 << (pin - SIM_SELECT_PIN);
+  uint8_t selected = value ? (channel | bit) : (channel & ~bit);
+  if (selected != channel) {
+    // Switching during the final low pulse is harmless, all bits are sent.
+    if (responder >= 0 && now - responseAt < edges[edgeCount - 2]) {
+      simStats.cutResponses++;
+    }
+    channel = selected;
+    switchedAt = now;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  now += 0.25;
+  if (pin != SIM_DATA_PIN || responder != channel) {
+    return pin == SIM_DATA_PIN && driving ? LOW : HIGH;
+  }
+  // The clock only moves forward, so pick up where the last call stopped.
+  while (edgesPassed < edgeCount && edges[edgesPassed] <= now - responseAt) {
+    edgesPassed++;
+  }
+  return edgesPassed % 2 ? LOW : HIGH;
+}
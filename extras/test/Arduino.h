@@ -0,0 +1,38 @@
+/*!
+ *  @file Arduino.h
+ *
+ *  Simulated Arduino core for the host tests: a virtual clock and digital
+ *  pins wired to the simulated sensors in sim.h.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+#define F(x) x
+#define F_CPU 16000000L
+#define microsecondsToClockCycles(a) ((a) * (F_CPU / 1000000L))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t usec);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#endif
@@ -0,0 +1,79 @@
+/*!
+ *  @file bench_frame.cpp
+ *
+ *  Throughput of dhtDecodeFrames() against the per frame functions on 4M
+ *  random DHT22 frames.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <vector>
+
+#include "DHT_Frame.h"
+
+#define FRAMES 4000000 /**< Frames per pass */
+#define REPEAT 10      /**< Passes per measurement */
+
+static uint32_t seed = 7;
+
+static uint32_t nextRandom() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+static double now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*!
+ *  @brief  Run the frame decoding benchmarks
+ *  @return 0
+ */
+int main() {
+  std::vector<uint8_t> frames(5 * FRAMES);
+  for (size_t i = 0; i < FRAMES; i++) {
+    uint8_t* frame = &frames[5 * i];
+    for (int j = 0; j < 4; j++) {
+      frame[j] = nextRandom();
+    }
+    frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+    if (i % 16 == 0) {
+      frame[4]++;
+    }
+  }
+  std::vector<float> temperature(FRAMES), humidity(FRAMES);
+
+  for (int single = 0; single < 2; single++) {
+    double start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      dhtDecodeFrames(DHT22, frames.data(), FRAMES, temperature.data(),
+                      humidity.data(), single);
+    }
+    double seconds = (now() - start) / REPEAT;
+    printf("dhtDecodeFrames, %s precision  %6.0f Mframes/s\n",
+           single ? "single" : "double", FRAMES / seconds / 1e6);
+  }
+
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (size_t i = 0; i < FRAMES; i++) {
+      const uint8_t* frame = &frames[5 * i];
+      if (dhtFrameValid(frame)) {
+        temperature[i] = dhtFrameTemperature(DHT22, frame);
+        humidity[i] = dhtFrameHumidity(DHT22, frame);
+      } else {
+        temperature[i] = humidity[i] = NAN;
+      }
+    }
+  }
+  double seconds = (now() - start) / REPEAT;
+  printf("per frame functions              %6.0f Mframes/s\n",
+         FRAMES / seconds / 1e6);
+  return 0;
+}
@@ -0,0 +1,75 @@
+/*!
+ *  @file bench_log.cpp
+ *
+ *  Size and decode speed of the DHT_Log format on day-long DHT22 traces.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "DHT_Log.h"
+#include "trace.h"
+
+#define CSV_BYTES 20 /**< Typical "millis,humidity,temperature" CSV line */
+#define REPEAT 20    /**< Decode passes per trace */
+
+// Log a day at the given period with timestamp jitter and +-1 LSB noise.
+static void run(const char* name, uint32_t period, uint32_t jitter,
+                bool noise) {
+  DHT_LogEncoder encoder;
+  std::vector<uint8_t> log;
+  uint32_t seed = 42, timestamp = 123456;
+  size_t count = 0;
+
+  for (uint32_t ms = 0; ms < 86400000; ms += period) {
+    double t, h;
+    dayTrace(ms / 1000.0, &t, &h);
+    if (noise) {
+      t += 0.1 * ((int)(traceRandom(&seed) % 3) - 1);
+      h += 0.1 * ((int)(traceRandom(&seed) % 3) - 1);
+    }
+    uint8_t frame[5], bytes[DHT_LOG_MAX_RECORD];
+    dht22Frame(t, h, frame);
+    uint8_t n = encoder.encode(frame, timestamp, bytes);
+    log.insert(log.end(), bytes, bytes + n);
+    count++;
+    timestamp += period;
+    if (jitter) {
+      timestamp += traceRandom(&seed) % (2 * jitter + 1) - jitter;
+    }
+  }
+
+  std::vector<dht_log_record_t> records(count);
+  DHT_LogDecoder decoder;
+  size_t decoded = 0;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (int i = 0; i < REPEAT; i++) {
+    decoder.reset();
+    decoded = decoder.decodeAll(log.data(), log.size(), records.data(), count);
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count() /
+                   REPEAT;
+
+  printf("%-26s %6zu samples %7zu bytes %5.2f B/sample (CSV ~%d) "
+         "decode %6.1f Mrec/s%s\n",
+         name, count, log.size(), (double)log.size() / count, CSV_BYTES,
+         decoded / seconds / 1e6, decoded == count ? "" : " MISMATCH");
+}
+
+/*!
+ *  @brief  Run the log benchmarks
+ *  @return 0
+ */
+int main() {
+  run("2s, no jitter, smooth", 2000, 0, false);
+  run("2s, +-2ms jitter, noisy", 2000, 2, true);
+  run("10s, +-5ms jitter, noisy", 10000, 5, true);
+  run("60s, no jitter, noisy", 60000, 0, true);
+  return 0;
+}
@@ -0,0 +1,56 @@
+/*!
+ *  @file bench_psychrometrics.cpp
+ *
+ *  Throughput of DHT_Psychrometrics::compute() with the polynomial exp/log
+ *  approximations against the C library exp() and log() on 1M samples.
+ */
+
+#include <stdio.h>
+
+#include <chrono>
+#include <vector>
+
+#include "DHT_Psychrometrics.h"
+
+#define SAMPLES 1000000 /**< Samples per pass */
+#define REPEAT 10       /**< Passes per measurement */
+
+static uint32_t seed = 7;
+
+static uint32_t nextRandom() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+static double now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*!
+ *  @brief  Run the psychrometrics benchmarks
+ *  @return 0
+ */
+int main() {
+  std::vector<float> temperature(SAMPLES), humidity(SAMPLES);
+  for (size_t i = 0; i < SAMPLES; i++) {
+    temperature[i] = (int)(nextRandom() % 1201) / 10.0F - 40;
+    humidity[i] = (int)(nextRandom() % 991) / 10.0F + 1;
+  }
+  std::vector<dht_psychrometrics_t> values(SAMPLES);
+
+  for (int fast = 1; fast >= 0; fast--) {
+    double start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      DHT_Psychrometrics::compute(temperature.data(), humidity.data(),
+                                  values.data(), SAMPLES, fast);
+    }
+    double seconds = (now() - start) / REPEAT;
+    printf("compute, %s  %6.1f Msamples/s\n",
+           fast ? "fast exp/log" : "libm exp/log", SAMPLES / seconds / 1e6);
+  }
+  return 0;
+}
@@ -0,0 +1,61 @@
+/*!
+ *  @file bench_unified.cpp
+ *
+ *  Cost per event of reading 16 DHT_Unified sensors one event at a time
+ *  against the batch DHT_Unified::getEvents(), with cached frames.
+ */
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include "DHT_U.h"
+#include "sim.h"
+
+#define SENSORS 16     /**< Sensors read per round */
+#define ROUNDS 200000  /**< Rounds per measurement */
+
+static double now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*!
+ *  @brief  Run the DHT_Unified benchmarks
+ *  @return 0
+ */
+int main() {
+  simReset();
+  DHT_Unified* sensors[SENSORS];
+  for (int i = 0; i < SENSORS; i++) {
+    sensors[i] = new DHT_Unified(SIM_DATA_PIN, DHT22, 6, 2 * i, 2 * i + 1);
+    sensors[i]->begin();
+  }
+  // The first read of every sensor goes over the simulated bus, after that
+  // the frozen clock keeps serving the cached frame.
+  static sensors_event_t events[2 * SENSORS];
+  uint8_t valid = DHT_Unified::getEvents(sensors, SENSORS, events);
+
+  double start = now();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < SENSORS; i++) {
+      sensors[i]->temperature().getEvent(&events[2 * i]);
+      sensors[i]->humidity().getEvent(&events[2 * i + 1]);
+    }
+  }
+  double single = (now() - start) / ROUNDS / (2 * SENSORS);
+
+  start = now();
+  for (int r = 0; r < ROUNDS; r++) {
+    DHT_Unified::getEvents(sensors, SENSORS, events);
+  }
+  double batch = (now() - start) / ROUNDS / (2 * SENSORS);
+
+  printf("%d/%d sensors valid, %.1f C %.1f %%\n", valid, SENSORS,
+         events[0].temperature, events[1].relative_humidity);
+  printf("getEvent()          %5.1f ns/event\n", single * 1e9);
+  printf("batch getEvents()   %5.1f ns/event (%.2fx)\n", batch * 1e9,
+         single / batch);
+  return 0;
+}
@@ -0,0 +1,54 @@
+/*!
+ *  @file sim.h
+ *
+ *  Simulated DHT sensors for the host tests.  Up to 16 sensors hang off the
+ *  data pin SIM_DATA_PIN, behind an analog mux whose four select lines are
+ *  SIM_SELECT_PIN and the three pins above it.  Code that never touches the
+ *  select lines talks to the sensor on channel 0.
+ *
+ *  A sensor answers a start signal that held the line low long enough for
+ *  its type with its frame, timed like the data sheet in microseconds of the
+ *  virtual clock.  Each call to micros() or digitalRead() advances the clock
+ *  a little, like the loop it is called from would.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "Arduino.h"
+
+#define SIM_DATA_PIN 7   /**< Data line of every sensor */
+#define SIM_SELECT_PIN 2 /**< First of four mux select lines */
+#define SIM_CHANNELS 16  /**< Mux channels */
+
+/*!
+ *  @brief  One simulated sensor
+ */
+typedef struct {
+  uint8_t type;       /**< DHT11, DHT21 or DHT22, 0 if nothing is connected */
+  float temperature;  /**< Current temperature in Celcius */
+  float humidity;     /**< Current relative humidity in percent */
+  int8_t marginalBit; /**< Bit sent wrong with a high pulse about as long as
+                           its low pulse, or -1 */
+} sim_sensor_t;
+
+/*!
+ *  @brief  Bus events counted since simReset()
+ */
+typedef struct {
+  uint32_t responses;       /**< Frames sent by any sensor */
+  uint32_t unsettledStarts; /**< Start signals sent before the line settled */
+  uint32_t cutResponses;    /**< Frames cut short by a channel switch */
+} sim_stats_t;
+
+extern sim_sensor_t simSensors[SIM_CHANNELS]; /**< Sensor on each channel */
+extern sim_stats_t simStats;                  /**< Bus event counters */
+extern uint32_t simSettleTime; /**< Time (in usec) a channel needs after the
+                                    mux switched to it before a start signal
+                                    is seen reliably */
+
+void simReset();
+void simAdvance(double usec);
+double simTime();
+
+#endif
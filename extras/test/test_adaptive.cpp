@@ -0,0 +1,141 @@
+/*!
+ *  @file test_adaptive.cpp
+ *
+ *  Samples a simulated day of indoor climate through DHT_Adaptive and
+ *  compares bus reads and tracking error against fixed two second sampling.
+ */
+
+#include <stdio.h>
+
+#include "DHT_Adaptive.h"
+#include "sim.h"
+#include "trace.h"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+/*!
+ *  @brief  Result of sampling one simulated day
+ */
+typedef struct {
+  uint32_t reads;          /**< Bus reads */
+  double temperatureError; /**< Largest temperature error in C */
+  double humidityError;    /**< Largest humidity error in % */
+  bool inBounds;           /**< sampleInterval() stayed within its bounds */
+} day_t;
+
+// Read the sensor once a second for a day, with maxInterval 0 meaning plain
+// DHT reads.  The sensor reports the trace plus +-0.05 C of noise, errors are
+// measured against the trace itself.
+static day_t sampleDay(uint32_t maxInterval, float deadband) {
+  simReset();
+  DHT dht(SIM_DATA_PIN, DHT22);
+  DHT_Adaptive adaptive(dht, 2000, maxInterval, deadband);
+  dht.begin();
+  day_t day = {0, 0, 0, true};
+  uint32_t seed = 9;
+  double start = simTime();
+
+  for (uint32_t s = 0; s < 86400; s++) {
+    simAdvance(start + s * 1e6 - simTime());
+    double t, h;
+    dayTrace(s, &t, &h);
+    double noise = traceRandom(&seed) % 5 == 0 ? 0.05 : 0;
+    simSensors[0].temperature = t + noise * ((int)(traceRandom(&seed) % 3) - 1);
+    simSensors[0].humidity = h;
+
+    float temperature, humidity;
+    if (maxInterval) {
+      temperature = adaptive.readTemperature();
+      humidity = adaptive.readHumidity();
+      uint32_t interval = adaptive.sampleInterval();
+      day.inBounds &= interval >= 2000 && interval <= maxInterval;
+    } else {
+      temperature = dht.readTemperature();
+      humidity = dht.readHumidity();
+    }
+    day.temperatureError = fmax(day.temperatureError, fabs(temperature - t));
+    day.humidityError = fmax(day.humidityError, fabs(humidity - h));
+  }
+  day.reads = simStats.responses;
+  return day;
+}
+
+static void testDay() {
+  day_t fixed = sampleDay(0, 0);
+  printf("fixed 2s:               %5u reads, max error %.2f C / %.2f %%RH\n",
+         (unsigned)fixed.reads, fixed.temperatureError, fixed.humidityError);
+  expect(fixed.reads == 43200, "fixed sampling reads every two seconds");
+
+  const uint32_t ceilings[] = {60000, 300000, 900000};
+  for (int i = 0; i < 3; i++) {
+    day_t day = sampleDay(ceilings[i], 0.2);
+    printf("%3us, deadband 0.2:     %5u reads (%4.1f%%), max error %.2f C / "
+           "%.2f %%RH\n",
+           (unsigned)(ceilings[i] / 1000), (unsigned)day.reads,
+           100.0 * day.reads / fixed.reads, day.temperatureError,
+           day.humidityError);
+    expect(day.inBounds, "interval stays within its bounds");
+    expect(day.reads < fixed.reads / 10, "under a tenth of the bus reads");
+    if (i == 0) {
+      expect(day.temperatureError < 0.2 && day.humidityError < 1,
+             "one minute ceiling tracks within 0.2 C and 1 %RH");
+    }
+  }
+}
+
+// The interval doubles on every unchanged frame and a changed frame or a
+// failed read drops it back to the minimum.
+static void testSteps() {
+  simReset();
+  DHT dht(SIM_DATA_PIN, DHT22);
+  DHT_Adaptive adaptive(dht, 2500, 30000, 0.1);
+  dht.begin();
+
+  expect(adaptive.read(), "first read");
+  expect(adaptive.sampleInterval() == 3000, "minimum rounds up to seconds");
+  const uint32_t expected[] = {6000, 12000, 24000, 30000, 30000};
+  for (int i = 0; i < 5; i++) {
+    simSensors[0].temperature += i % 2 ? 0.1F : -0.1F;
+    simAdvance(adaptive.sampleInterval() * 1000.0);
+    expect(adaptive.read(), "read");
+    expect(adaptive.sampleInterval() == expected[i],
+           "changes within the deadband double the interval");
+  }
+  uint32_t reads = simStats.responses;
+  simAdvance(29000e3);
+  expect(adaptive.read() && simStats.responses == reads,
+         "reads within the interval are cached");
+
+  simSensors[0].humidity += 0.2F;
+  simAdvance(1000e3);
+  expect(adaptive.read() && adaptive.sampleInterval() == 3000,
+         "a change beyond the deadband restarts at the minimum");
+
+  simAdvance(3000e3);
+  expect(adaptive.read() && adaptive.sampleInterval() == 6000, "doubles");
+  simSensors[0].type = 0;
+  simAdvance(6000e3);
+  expect(!adaptive.read() && adaptive.sampleInterval() == 3000,
+         "a failed read restarts at the minimum");
+  simSensors[0].type = DHT22;
+  simAdvance(2000e3);
+  expect(adaptive.read(), "failed reads are retried after two seconds");
+}
+
+/*!
+ *  @brief  Run the adaptive sampling tests
+ *  @return 0 if all checks passed
+ */
+int main() {
+  testSteps();
+  testDay();
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
@@ -0,0 +1,211 @@
+/*!
+ *  @file test_correction.cpp
+ *
+ *  Corpus test for the single bit error correction of dhtDecodePulses().
+ *  Frames are turned into pulse trains with jitter, then corrupted in ways
+ *  seen in the field (a marginal bit on the wrong side of the threshold) and
+ *  in ways the corrector must not paper over (wrong bits that are not
+ *  marginal).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "DHT_Frame.h"
+
+#define FRAMES 200000 /**< Frames per scenario */
+#define LOW_PULSE 500 /**< Nominal low pulse, 50us in 0.1us units */
+
+static uint32_t state = 12345;
+
+static uint32_t nextRandom(uint32_t n) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state % n;
+}
+
+static uint8_t bitOf(const uint8_t* frame, uint8_t i) {
+  return (frame[i / 8] >> (7 - i % 8)) & 1;
+}
+
+static void randomFrame(uint8_t* frame) {
+  for (uint8_t i = 0; i < 4; i++) {
+    frame[i] = nextRandom(256);
+  }
+  frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+}
+
+// High pulse of a bit that is not marginal: ~26us for a 0 and ~70us for a 1,
+// more than a quarter of the longest low pulse away from it.
+static uint32_t strongHigh(uint8_t value) {
+  return value ? 680 + nextRandom(101) : 210 + nextRandom(101);
+}
+
+// Clean pulses with jitter.
+static void encode(const uint8_t* frame, uint32_t* pulses) {
+  for (uint8_t i = 0; i < 40; i++) {
+    pulses[2 * i] = LOW_PULSE - 20 + nextRandom(41);
+    pulses[2 * i + 1] = strongHigh(bitOf(frame, i));
+  }
+}
+
+// Make bit i marginal: its high pulse lands within a quarter of the low
+// pulse, on the side that decodes to value.
+static void makeMarginal(uint32_t* pulses, uint8_t i, uint8_t value) {
+  uint32_t low = pulses[2 * i];
+  uint32_t offset = 1 + nextRandom(low / 4);
+  pulses[2 * i + 1] = value ? low + offset : low - offset + 1;
+}
+
+// Make bit i decode to value with a high pulse that is not marginal.
+static void makeStrong(uint32_t* pulses, uint8_t i, uint8_t value) {
+  pulses[2 * i + 1] = strongHigh(value);
+}
+
+// Pick n distinct bit positions.
+static void pickBits(uint8_t* bits, uint8_t n) {
+  for (uint8_t k = 0; k < n; k++) {
+    bool again;
+    do {
+      bits[k] = nextRandom(40);
+      again = false;
+      for (uint8_t j = 0; j < k; j++) {
+        again |= bits[j] == bits[k];
+      }
+    } while (again);
+  }
+}
+
+/*!
+ *  @brief  Outcome counts of one scenario
+ */
+struct Counts {
+  uint32_t ok;         /**< Decoded to the frame that was sent */
+  uint32_t undetected; /**< Checksum matched a different frame */
+  uint32_t corrected;  /**< Corrected to the frame that was sent */
+  uint32_t miscorrect; /**< "Corrected" to a different frame */
+  uint32_t rejected;   /**< Checksum failure */
+};
+
+static void decode(const uint32_t* pulses, const uint8_t* sent, bool correct,
+                   Counts* counts) {
+  uint8_t frame[5];
+  switch (dhtDecodePulses(pulses, frame, correct)) {
+    case DHT_DECODE_OK:
+      if (memcmp(frame, sent, 5) == 0) {
+        counts->ok++;
+      } else {
+        counts->undetected++;
+      }
+      break;
+    case DHT_DECODE_CORRECTED:
+      if (memcmp(frame, sent, 5) == 0) {
+        counts->corrected++;
+      } else {
+        counts->miscorrect++;
+      }
+      break;
+    default:
+      counts->rejected++;
+      break;
+  }
+}
+
+static int failures = 0;
+
+static void report(const char* name, const Counts& c) {
+  printf("%-44s ok %6u undetected %5u corrected %6u miscorrected %5u "
+         "rejected %6u\n",
+         name, (unsigned)c.ok, (unsigned)c.undetected, (unsigned)c.corrected,
+         (unsigned)c.miscorrect, (unsigned)c.rejected);
+}
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+/*!
+ *  @brief  Run every scenario and check the outcome counts
+ *  @return 0 if all checks passed
+ */
+int main() {
+  uint8_t sent[5], bits[3];
+  uint32_t pulses[80];
+  Counts clean = {}, oneWeak = {}, oneWeakOff = {}, twoWeak = {},
+         twoGoodOneStrong = {}, oneGoodOneStrong = {}, strong = {};
+
+  for (uint32_t n = 0; n < FRAMES; n++) {
+    // A correct marginal bit is fine with or without correction.
+    randomFrame(sent);
+    encode(sent, pulses);
+    pickBits(bits, 1);
+    makeMarginal(pulses, bits[0], bitOf(sent, bits[0]));
+    decode(pulses, sent, true, &clean);
+
+    // The field case: one marginal bit decoded the wrong way.
+    makeMarginal(pulses, bits[0], !bitOf(sent, bits[0]));
+    decode(pulses, sent, true, &oneWeak);
+    decode(pulses, sent, false, &oneWeakOff);
+
+    // Two marginal bits, both wrong: must not be corrected.  Errors of the
+    // same weight in opposite directions cancel in the checksum and go
+    // undetected with or without correction.
+    randomFrame(sent);
+    encode(sent, pulses);
+    pickBits(bits, 2);
+    makeMarginal(pulses, bits[0], !bitOf(sent, bits[0]));
+    makeMarginal(pulses, bits[1], !bitOf(sent, bits[1]));
+    decode(pulses, sent, true, &twoWeak);
+
+    // Two correct marginal bits and a wrong bit that is not marginal.
+    randomFrame(sent);
+    encode(sent, pulses);
+    pickBits(bits, 3);
+    makeMarginal(pulses, bits[0], bitOf(sent, bits[0]));
+    makeMarginal(pulses, bits[1], bitOf(sent, bits[1]));
+    makeStrong(pulses, bits[2], !bitOf(sent, bits[2]));
+    decode(pulses, sent, true, &twoGoodOneStrong);
+
+    // One correct marginal bit and a wrong bit that is not marginal: the
+    // residual risk documented in dhtDecodePulses().
+    randomFrame(sent);
+    encode(sent, pulses);
+    pickBits(bits, 2);
+    makeMarginal(pulses, bits[0], bitOf(sent, bits[0]));
+    makeStrong(pulses, bits[1], !bitOf(sent, bits[1]));
+    decode(pulses, sent, true, &oneGoodOneStrong);
+
+    // A wrong bit that is not marginal and no marginal bits at all.
+    randomFrame(sent);
+    encode(sent, pulses);
+    pickBits(bits, 1);
+    makeStrong(pulses, bits[0], !bitOf(sent, bits[0]));
+    decode(pulses, sent, true, &strong);
+  }
+
+  report("one correct marginal bit", clean);
+  report("one wrong marginal bit", oneWeak);
+  report("one wrong marginal bit, correction off", oneWeakOff);
+  report("two wrong marginal bits", twoWeak);
+  report("two correct marginal + one wrong strong bit", twoGoodOneStrong);
+  report("one correct marginal + one wrong strong bit", oneGoodOneStrong);
+  report("one wrong strong bit", strong);
+
+  expect(clean.ok == FRAMES, "correct marginal bits decode unchanged");
+  expect(oneWeak.corrected == FRAMES, "one wrong marginal bit is repaired");
+  expect(oneWeakOff.rejected == FRAMES, "correction off rejects");
+  expect(twoWeak.corrected + twoWeak.miscorrect == 0,
+         "two marginal bits are rejected");
+  expect(twoGoodOneStrong.corrected + twoGoodOneStrong.miscorrect == 0,
+         "two marginal bits with a strong error are rejected");
+  expect(oneGoodOneStrong.miscorrect < FRAMES / 12,
+         "residual miscorrection rate below 1/12");
+  expect(strong.corrected + strong.miscorrect == 0,
+         "strong errors alone are rejected");
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
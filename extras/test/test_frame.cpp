@@ -0,0 +1,212 @@
+/*!
+ *  @file test_frame.cpp
+ *
+ *  Checks dhtFrameTemperature(), dhtFrameHumidity() and dhtDecodeFrames()
+ *  bit for bit against a reference that rounds every operation explicitly,
+ *  for every 16 bit temperature and humidity word and in both precisions.
+ *  The Makefile also builds it with AVX2 and with FMA contraction enabled.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "DHT_Frame.h"
+
+#define FRAMES (65536 + 3) /**< Every word, plus a tail for the scalar loop */
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+// f + b * 0.1 and f * 0.1 as the original DHT code evaluates them, with
+// double as wide as float when single is set.  volatile forces every
+// intermediate result to be rounded, so the compiler cannot fuse them.
+static float plusTenths(float f, int b, bool single) {
+  if (single) {
+    volatile float product = b * 0.1F;
+    volatile float sum = f + product;
+    return sum;
+  }
+  volatile double product = b * 0.1;
+  volatile double sum = f + product;
+  return (float)sum;
+}
+
+static float timesTenth(float f, bool single) {
+  if (single) {
+    volatile float product = f * 0.1F;
+    return product;
+  }
+  volatile double product = f * 0.1;
+  return (float)product;
+}
+
+static float referenceTemperature(uint8_t type, const uint8_t* frame,
+                                  bool single) {
+  float f = NAN;
+  switch (type) {
+    case DHT11:
+      f = frame[2];
+      if (frame[3] & 0x80) {
+        f = -1 - f;
+      }
+      f = plusTenths(f, frame[3] & 0x0f, single);
+      break;
+    case DHT12:
+      f = plusTenths(frame[2], frame[3] & 0x0f, single);
+      if (frame[2] & 0x80) {
+        f *= -1;
+      }
+      break;
+    case DHT21:
+    case DHT22:
+      f = timesTenth(((uint16_t)(frame[2] & 0x7F)) << 8 | frame[3], single);
+      if (frame[2] & 0x80) {
+        f *= -1;
+      }
+      break;
+  }
+  return f;
+}
+
+static float referenceHumidity(uint8_t type, const uint8_t* frame,
+                               bool single) {
+  float f = NAN;
+  switch (type) {
+    case DHT11:
+    case DHT12:
+      f = plusTenths(frame[0], frame[1], single);
+      break;
+    case DHT21:
+    case DHT22:
+      f = timesTenth(((uint16_t)frame[0]) << 8 | frame[1], single);
+      break;
+  }
+  return f;
+}
+
+static bool sameBits(float a, float b) {
+  return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Frames whose humidity and temperature words both run through every 16 bit
+// value, with every 7th checksum broken.
+static std::vector<uint8_t> makeFrames() {
+  std::vector<uint8_t> frames(5 * FRAMES);
+  for (size_t i = 0; i < FRAMES; i++) {
+    uint8_t* frame = &frames[5 * i];
+    uint16_t word = i;
+    frame[0] = frame[2] = word >> 8;
+    frame[1] = frame[3] = word & 0xFF;
+    frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+    if (i % 7 == 3) {
+      frame[4] ^= 0x10;
+    }
+  }
+  return frames;
+}
+
+static void testType(uint8_t type, const std::vector<uint8_t>& frames) {
+  std::vector<float> temperature(FRAMES), humidity(FRAMES);
+  char what[80];
+
+  for (int single = 0; single < 2; single++) {
+    size_t valid = dhtDecodeFrames(type, frames.data(), FRAMES,
+                                   temperature.data(), humidity.data(), single);
+    size_t expected = 0, mismatches = 0;
+    for (size_t i = 0; i < FRAMES; i++) {
+      const uint8_t* frame = &frames[5 * i];
+      float t = NAN, h = NAN;
+      if (dhtFrameValid(frame)) {
+        t = referenceTemperature(type, frame, single);
+        h = referenceHumidity(type, frame, single);
+        expected++;
+      }
+      if (!sameBits(t, temperature[i]) || !sameBits(h, humidity[i])) {
+        mismatches++;
+      }
+    }
+    snprintf(what, sizeof(what), "DHT%d %s bulk decode matches reference",
+             type, single ? "single" : "double");
+    expect(mismatches == 0 && valid == expected, what);
+  }
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < FRAMES; i++) {
+    const uint8_t* frame = &frames[5 * i];
+    bool single = sizeof(double) == sizeof(float);
+    if (!sameBits(dhtFrameTemperature(type, frame),
+                  referenceTemperature(type, frame, single)) ||
+        !sameBits(dhtFrameHumidity(type, frame),
+                  referenceHumidity(type, frame, single))) {
+      mismatches++;
+    }
+  }
+  snprintf(what, sizeof(what), "DHT%d per frame functions match reference",
+           type);
+  expect(mismatches == 0, what);
+}
+
+// Count the values where the two precisions disagree, i.e. where a host and
+// an AVR node convert the same frame differently.
+static void testPrecisionsDiffer() {
+  size_t words = 0, pairs = 0;
+  uint8_t frame[5] = {0, 0, 0, 0, 0};
+  for (uint32_t word = 0; word < 0x8000; word++) {
+    frame[2] = word >> 8;
+    frame[3] = word & 0xFF;
+    if (!sameBits(referenceTemperature(DHT22, frame, false),
+                  referenceTemperature(DHT22, frame, true))) {
+      words++;
+    }
+  }
+  for (uint32_t pair = 0; pair < 0x10000; pair++) {
+    frame[0] = pair >> 8;
+    frame[1] = pair & 0xFF;
+    if (!sameBits(referenceHumidity(DHT11, frame, false),
+                  referenceHumidity(DHT11, frame, true))) {
+      pairs++;
+    }
+  }
+  printf("precisions differ on %zu of 32768 DHT22 words, %zu of 65536 DHT11 "
+         "byte pairs\n",
+         words, pairs);
+  expect(words > 0 && pairs > 0, "single precision mode changes results");
+}
+
+// dhtStartPulse() reads the same start pulse dhtModel() copies, for known
+// and unknown types.
+static void testStartPulse() {
+  for (uint32_t type = 0; type < 256; type++) {
+    dht_model_t model;
+    dhtModel(type, &model);
+    if (dhtStartPulse(type) != model.startPulse) {
+      expect(false, "dhtStartPulse() matches dhtModel()");
+      return;
+    }
+  }
+}
+
+/*!
+ *  @brief  Run the frame conversion tests
+ *  @return 0 if all checks passed
+ */
+int main() {
+  std::vector<uint8_t> frames = makeFrames();
+  testType(DHT11, frames);
+  testType(DHT12, frames);
+  testType(DHT21, frames);
+  testType(DHT22, frames);
+  testPrecisionsDiffer();
+  testStartPulse();
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
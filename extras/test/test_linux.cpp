@@ -0,0 +1,205 @@
+/*!
+ *  @file test_linux.cpp
+ *
+ *  Replays synthetic edge captures through DHT_Linux, checking the edge to
+ *  pulse conversion of the Linux backend without GPIO hardware.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "DHT_Linux.h"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+static uint32_t seed = 11;
+
+static uint32_t nextRandom() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+/*!
+ *  @brief  Edge source that replays the transmission of a given frame as the
+ *          kernel would report it, in batches of random size
+ */
+class ReplayEdgeSource : public DHT_EdgeSource {
+ public:
+  uint8_t frame[5];   /**< Frame the simulated sensor sends */
+  bool leadingEdge;   /**< Report the rising edge of the start release */
+  bool trailingEdge;  /**< Report the rising edge of the final release */
+  int dropAfter;      /**< Fail readEdges() after this many edges, or -1 */
+  int marginalBit;    /**< Bit sent wrong with a high pulse about as long as
+                           its low pulse, or -1 */
+  uint64_t clock;     /**< Timestamp of the next start signal in ns */
+
+  ReplayEdgeSource()
+      : leadingEdge(true), trailingEdge(true), dropAfter(-1), marginalBit(-1),
+        clock(0) {
+    memset(frame, 0, sizeof(frame));
+  }
+  bool begin() { return true; }
+  bool start(uint32_t usec) {
+    _edges.clear();
+    _next = 0;
+    _time = clock + usec * 1000ULL;
+    if (leadingEdge) {
+      add(true, 0);
+    }
+    // Sensor response: 80us low, 80us high, then 40 bits of ~50us low and
+    // 26-28us (0) or 70us (1) high, with up to 3us of jitter per pulse.  The
+    // marginal bit has a 50us low and a 48us (1) or 52us (0) high pulse.
+    add(false, 20000 + nextRandom() % 20000);
+    add(true, 80000);
+    uint64_t high = 80000;
+    for (int i = 0; i < 40; i++) {
+      bool bit = (frame[i / 8] >> (7 - i % 8)) & 1;
+      add(false, high);
+      if (i == marginalBit) {
+        add(true, 50000);
+        high = bit ? 48000 : 52000;
+        continue;
+      }
+      add(true, 50000 + nextRandom() % 3000);
+      high = (bit ? 70000 : 26000) + nextRandom() % 3000;
+    }
+    add(false, high);
+    if (trailingEdge) {
+      add(true, 50000);
+    }
+    clock = _time + 1000000000ULL;
+    return true;
+  }
+  int readEdges(dht_edge_t* edges, int max, uint32_t) {
+    int n = _edges.size() - _next;
+    if (dropAfter >= 0 && _next + n > (size_t)dropAfter) {
+      return -1;
+    }
+    int batch = 1 + nextRandom() % 20;
+    n = n < batch ? n : batch;
+    n = n < max ? n : max;
+    memcpy(edges, &_edges[_next], n * sizeof(dht_edge_t));
+    _next += n;
+    return n;
+  }
+  void stop() {}
+
+ private:
+  std::vector<dht_edge_t> _edges;
+  size_t _next;
+  uint64_t _time;
+
+  void add(bool rising, uint64_t delay) {
+    _time += delay;
+    dht_edge_t edge = {_time, rising};
+    _edges.push_back(edge);
+  }
+};
+
+static void randomFrame(uint8_t* frame) {
+  for (int i = 0; i < 4; i++) {
+    frame[i] = nextRandom();
+  }
+  frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+}
+
+// Random frames with and without the edges around the transmission.
+static void testReplay() {
+  ReplayEdgeSource source;
+  DHT_Linux dht(source, DHT22);
+  expect(dht.begin(), "begin");
+  int decoded = 0, count = 1000;
+  for (int n = 0; n < count; n++) {
+    randomFrame(source.frame);
+    source.leadingEdge = n % 3 != 0;
+    source.trailingEdge = n % 2 != 0;
+    uint8_t frame[5];
+    if (dht.readRaw(frame, true) && memcmp(frame, source.frame, 5) == 0) {
+      decoded++;
+    }
+  }
+  printf("decoded %d/%d replayed frames\n", decoded, count);
+  expect(decoded == count, "every replayed frame decodes");
+}
+
+// A known frame converts to the expected values and is cached.
+static void testValues() {
+  ReplayEdgeSource source;
+  DHT_Linux dht(source, DHT22);
+  dht.begin();
+  const uint8_t frame[5] = {0x02, 0x8C, 0x81, 0x5F, 0x6E};
+  memcpy(source.frame, frame, sizeof(frame));
+  float temperature = dht.readTemperature(false, true);
+  float humidity = dht.readHumidity();
+  expect(temperature == -35.1F, "temperature of a known frame");
+  expect(humidity == 65.2F, "humidity of a known frame");
+
+  // Within two seconds the cached frame is returned without a capture.
+  randomFrame(source.frame);
+  uint8_t cached[5];
+  expect(dht.readRaw(cached) && memcmp(cached, frame, 5) == 0,
+         "reads within DHT_MIN_INTERVAL return the last frame");
+}
+
+// Captures that lose or clip edges must fail instead of decoding garbage.
+static void testBrokenCaptures() {
+  ReplayEdgeSource source;
+  DHT_Linux dht(source, DHT22);
+  dht.begin();
+  randomFrame(source.frame);
+  source.dropAfter = 40;
+  expect(!dht.read(true), "lost edges fail the read");
+  source.dropAfter = -1;
+  expect(dht.read(true), "read recovers after lost edges");
+
+  source.frame[4]++;
+  expect(!dht.read(true), "checksum errors fail the read");
+}
+
+// A frame with one marginal bit fails the checksum and is repaired only with
+// error correction on, which the flag and counter report.
+static void testCorrection() {
+  ReplayEdgeSource source;
+  DHT_Linux dht(source, DHT22);
+  dht.begin();
+  randomFrame(source.frame);
+  source.marginalBit = 21;
+  expect(!dht.read(true) && !dht.lastReadCorrected(),
+         "a marginal bit fails the checksum without correction");
+
+  dht.setErrorCorrection(true);
+  uint8_t frame[5];
+  expect(dht.readRaw(frame, true) && memcmp(frame, source.frame, 5) == 0,
+         "a marginal bit is corrected");
+  expect(dht.lastReadCorrected() && dht.correctedReadCount() == 1,
+         "a corrected frame is flagged and counted");
+
+  source.marginalBit = -1;
+  expect(dht.read(true) && !dht.lastReadCorrected(),
+         "a clean frame clears the flag");
+  expect(dht.correctedReadCount() == 1, "the count keeps corrected frames");
+}
+
+/*!
+ *  @brief  Run the Linux backend tests
+ *  @return 0 if all checks passed
+ */
+int main() {
+  testReplay();
+  testValues();
+  testBrokenCaptures();
+  testCorrection();
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
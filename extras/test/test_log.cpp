@@ -0,0 +1,171 @@
+/*!
+ *  @file test_log.cpp
+ *
+ *  Round trip and record size tests for DHT_LogEncoder and DHT_LogDecoder.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "DHT_Log.h"
+#include "trace.h"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+// Encode one record into a buffer of exactly DHT_LOG_MAX_RECORD bytes with
+// guard bytes behind it.  Returns the record size or -1 on an overflow.
+static int encodeGuarded(DHT_LogEncoder* encoder, const uint8_t* frame,
+                         uint32_t timestamp, uint8_t* record) {
+  uint8_t buffer[DHT_LOG_MAX_RECORD + 8];
+  memset(buffer, 0xA5, sizeof(buffer));
+  uint8_t n = encoder->encode(frame, timestamp, buffer);
+  for (size_t i = DHT_LOG_MAX_RECORD; i < sizeof(buffer); i++) {
+    if (buffer[i] != 0xA5) {
+      return -1;
+    }
+  }
+  memcpy(record, buffer, n);
+  return n > DHT_LOG_MAX_RECORD ? -1 : n;
+}
+
+// Records whose varints need the most bytes.
+static void testLargestRecords() {
+  uint8_t frame[5] = {0x03, 0xE8, 0x81, 0x90, 0};
+  uint8_t other[5] = {0x00, 0x00, 0x01, 0x90, 0};
+  uint8_t record[DHT_LOG_MAX_RECORD];
+  frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+  other[4] = other[0] + other[1] + other[2] + other[3];
+
+  // 300000000 is past 2^28 ms (3.1 days of uptime), with a 900s interval.
+  DHT_LogEncoder encoder(2);
+  encodeGuarded(&encoder, frame, 300000000 - 900000, record);
+  encodeGuarded(&encoder, frame, 300000000, record);
+  int n = encodeGuarded(&encoder, frame, 300000000 + 900000, record);
+  expect(n == 13, "keyframe after 3.1 days with a 900s interval is 13 bytes");
+
+  // Both varints of a keyframe at their 5 byte maximum.
+  encoder = DHT_LogEncoder(2);
+  encodeGuarded(&encoder, frame, 0, record);
+  encodeGuarded(&encoder, frame, 0xF0000000, record);
+  n = encodeGuarded(&encoder, frame, 0xFFFFFFFF, record);
+  expect(n == 15, "largest keyframe is 15 bytes and fits");
+
+  // Largest delta record: interval change and both values escaped.
+  encoder = DHT_LogEncoder(256);
+  encodeGuarded(&encoder, frame, 0, record);
+  encodeGuarded(&encoder, other, 0x7FFFFFFF, record);
+  n = encodeGuarded(&encoder, frame, 0x80000000, record);
+  expect(n > 0 && n <= DHT_LOG_MAX_RECORD, "largest delta record fits");
+}
+
+// Encode a day of samples and decode it in one go and in ragged chunks.
+static void testRoundTrip(uint32_t period, uint32_t jitter, bool noise) {
+  DHT_LogEncoder encoder;
+  std::vector<uint8_t> log;
+  std::vector<dht_log_record_t> sent;
+  uint32_t seed = 42, timestamp = 123456;
+  bool overflow = false;
+
+  for (uint32_t ms = 0; ms < 86400000; ms += period) {
+    double t, h;
+    dayTrace(ms / 1000.0, &t, &h);
+    if (noise) {
+      t += 0.1 * ((int)(traceRandom(&seed) % 3) - 1);
+      h += 0.1 * ((int)(traceRandom(&seed) % 3) - 1);
+    }
+    dht_log_record_t record;
+    record.timestamp = timestamp;
+    dht22Frame(t, h, record.data);
+    sent.push_back(record);
+
+    uint8_t bytes[DHT_LOG_MAX_RECORD];
+    int n = encodeGuarded(&encoder, record.data, timestamp, bytes);
+    overflow |= n < 0;
+    log.insert(log.end(), bytes, bytes + (n < 0 ? 0 : n));
+    timestamp += period;
+    if (jitter) {
+      timestamp += traceRandom(&seed) % (2 * jitter + 1) - jitter;
+    }
+  }
+
+  size_t count = sent.size(), used;
+  std::vector<dht_log_record_t> records(count);
+  DHT_LogDecoder decoder;
+  size_t decoded =
+      decoder.decodeAll(log.data(), log.size(), records.data(), count, &used);
+  bool same = decoded == count && used == log.size();
+  for (size_t i = 0; same && i < count; i++) {
+    same = records[i].timestamp == sent[i].timestamp &&
+           memcmp(records[i].data, sent[i].data, 5) == 0;
+  }
+
+  // Feed the log in ragged chunks as if it was read from a file, keeping
+  // incomplete records for the next chunk.
+  decoder.reset();
+  decoded = 0;
+  size_t offset = 0;
+  while (offset < log.size()) {
+    size_t end = offset + 1 + traceRandom(&seed) % 20;
+    if (end > log.size()) {
+      end = log.size();
+    }
+    decoded += decoder.decodeAll(log.data() + offset, end - offset,
+                                 records.data() + decoded, count - decoded,
+                                 &used);
+    offset += used;
+    if (end == log.size() && used == 0) {
+      break;
+    }
+  }
+  bool chunked = decoded == count;
+  for (size_t i = 0; chunked && i < count; i++) {
+    chunked = records[i].timestamp == sent[i].timestamp &&
+              memcmp(records[i].data, sent[i].data, 5) == 0;
+  }
+
+  double perSample = (double)log.size() / count;
+  printf("period %5ums jitter %ums noise %d: %.2f bytes/sample\n",
+         (unsigned)period, (unsigned)jitter, noise, perSample);
+  expect(!overflow, "no record overflows DHT_LOG_MAX_RECORD");
+  expect(same, "round trip");
+  expect(chunked, "chunked round trip");
+  expect(perSample < 3, "under 3 bytes per sample");
+}
+
+static void testCorrupt() {
+  uint8_t delta[] = {0x09};
+  uint8_t truncated[] = {DHT_LOG_KEYFRAME, 0x80, 0x80};
+  uint8_t overlong[] = {DHT_LOG_KEYFRAME, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80};
+  dht_log_record_t record;
+  DHT_LogDecoder decoder;
+  expect(decoder.decode(delta, sizeof(delta), &record) == -1,
+         "delta before keyframe is rejected");
+  expect(decoder.decode(truncated, sizeof(truncated), &record) == 0,
+         "truncated keyframe waits for more data");
+  expect(decoder.decode(overlong, sizeof(overlong), &record) == -1,
+         "overlong varint is rejected");
+}
+
+/*!
+ *  @brief  Run the log format tests
+ *  @return 0 if all checks passed
+ */
+int main() {
+  testLargestRecords();
+  testRoundTrip(2000, 0, false);
+  testRoundTrip(2000, 2, true);
+  testRoundTrip(10000, 5, true);
+  testRoundTrip(60000, 0, true);
+  testCorrupt();
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
@@ -0,0 +1,155 @@
+/*!
+ *  @file test_mux.cpp
+ *
+ *  Scans 16 simulated sensors of mixed types behind a simulated analog mux
+ *  through DHT_Mux.
+ */
+
+#include <stdio.h>
+
+#include "DHT_Mux.h"
+#include "sim.h"
+
+#define ABSENT 13 /**< Channel without a sensor */
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+static uint32_t seed = 1;
+
+static uint32_t nextRandom() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+// DHT22 on channels 0-7, DHT11 on 8-11, DHT21 on 12-15, nothing on ABSENT.
+static void setupSensors(DHT_Mux* mux) {
+  simReset();
+  for (uint8_t i = 0; i < SIM_CHANNELS; i++) {
+    uint8_t type = i < 8 ? DHT22 : i < 12 ? DHT11 : DHT21;
+    simSensors[i].type = i == ABSENT ? 0 : type;
+    simSensors[i].temperature = type == DHT11 ? 20.3F + i : -5.5F + i * 1.7F;
+    simSensors[i].humidity = type == DHT11 ? 40 + i : 30.2F + i * 2.3F;
+    if (mux && type != DHT22) {
+      mux->setType(i, type);
+    }
+  }
+}
+
+// Let every sensor's values drift by up to two steps of its resolution.
+static void drift() {
+  for (uint8_t i = 0; i < SIM_CHANNELS; i++) {
+    float step = simSensors[i].type == DHT11 ? 1 : 0.1F;
+    simSensors[i].temperature += step * ((int)(nextRandom() % 5) - 2);
+    simSensors[i].humidity += step * ((int)(nextRandom() % 5) - 2);
+  }
+}
+
+static void testScan() {
+  const uint8_t selectPins[] = {SIM_SELECT_PIN, SIM_SELECT_PIN + 1,
+                                SIM_SELECT_PIN + 2, SIM_SELECT_PIN + 3};
+  DHT_Mux mux(SIM_DATA_PIN, selectPins, 4, DHT22, 500);
+  setupSensors(&mux);
+  mux.begin();
+  expect(mux.channels() == 16, "four select lines address 16 channels");
+
+  int scans = 20, wrong = 0, incomplete = 0;
+  double scanTime = 0;
+  for (int n = 0; n < scans; n++) {
+    drift();
+    double start = simTime();
+    if (mux.scan(true) != SIM_CHANNELS - 1) {
+      incomplete++;
+    }
+    scanTime += simTime() - start;
+    for (uint8_t i = 0; i < SIM_CHANNELS; i++) {
+      float temperature = mux.readTemperature(i);
+      float humidity = mux.readHumidity(i);
+      if (i == ABSENT) {
+        wrong += !isnan(temperature) || !isnan(humidity);
+      } else if (fabs(temperature - simSensors[i].temperature) > 0.051 ||
+                 fabs(humidity - simSensors[i].humidity) > 0.051) {
+        printf("channel %d: %.2f C %.2f %% read, %.2f C %.2f %% sent\n", i,
+               temperature, humidity, simSensors[i].temperature,
+               simSensors[i].humidity);
+        wrong++;
+      }
+    }
+    simAdvance(2100e3);
+  }
+  printf("scan of 16 channels: %.1f ms\n", scanTime / scans / 1000);
+  expect(incomplete == 0, "every present sensor answers every scan");
+  expect(wrong == 0, "every channel reads its own sensor");
+  expect(simStats.unsettledStarts == 0, "start signals wait for the settle");
+  expect(simStats.cutResponses == 0, "no channel switch during a response");
+
+  // Reads within two seconds of a scan use its results.
+  uint32_t responses = simStats.responses;
+  mux.scan();
+  mux.readTemperature(0);
+  expect(simStats.responses == responses + SIM_CHANNELS - 1,
+         "one scan per two seconds");
+
+  uint8_t frame[5];
+  expect(!mux.readRaw(ABSENT, frame), "absent sensor has no frame");
+  expect(!mux.read(SIM_CHANNELS), "channels beyond the mux are invalid");
+}
+
+// A settle time below what the channels need is caught by the simulation.
+static void testShortSettle() {
+  const uint8_t selectPins[] = {SIM_SELECT_PIN, SIM_SELECT_PIN + 1};
+  DHT_Mux mux(SIM_DATA_PIN, selectPins, 2, DHT22, 100);
+  setupSensors(&mux);
+  mux.begin();
+  mux.scan(true);
+  expect(simStats.unsettledStarts > 0, "short settle time is detected");
+}
+
+// A channel whose frame has one marginal bit is repaired only with error
+// correction on, and only that channel is reported as corrected.
+static void testCorrection() {
+  const uint8_t selectPins[] = {SIM_SELECT_PIN, SIM_SELECT_PIN + 1};
+  DHT_Mux mux(SIM_DATA_PIN, selectPins, 2, DHT22, 500);
+  setupSensors(&mux);
+  mux.begin();
+  simSensors[1].marginalBit = 21;
+  expect(mux.scan(true) == 3 && !mux.read(1),
+         "a marginal bit fails the checksum without correction");
+  expect(!mux.lastReadCorrected(1), "a failed frame is not corrected");
+
+  mux.setErrorCorrection(true);
+  simAdvance(2100e3);
+  expect(mux.scan(true) == 4 &&
+             fabs(mux.readTemperature(1) - simSensors[1].temperature) < 0.051,
+         "a marginal bit is corrected");
+  expect(mux.lastReadCorrected(1) && !mux.lastReadCorrected(0) &&
+             !mux.lastReadCorrected(2) && !mux.lastReadCorrected(3),
+         "only the repaired channel is flagged");
+  expect(mux.correctedReadCount() == 1, "a corrected frame is counted");
+
+  simSensors[1].marginalBit = -1;
+  simAdvance(2100e3);
+  expect(mux.scan(true) == 4 && !mux.lastReadCorrected(1),
+         "a clean frame clears the flag");
+  expect(mux.correctedReadCount() == 1, "the count keeps corrected frames");
+}
+
+/*!
+ *  @brief  Run the mux driver tests
+ *  @return 0 if all checks passed
+ */
+int main() {
+  testScan();
+  testShortSettle();
+  testCorrection();
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
@@ -0,0 +1,116 @@
+/*!
+ *  @file test_psychrometrics.cpp
+ *
+ *  Checks DHT_Psychrometrics against the Magnus formula evaluated in double
+ *  precision and checks that derived values are cached per frame.
+ */
+
+#include <stdio.h>
+
+#include "DHT_Psychrometrics.h"
+#include "sim.h"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+// The formulas of DHT_Psychrometrics::compute() in double precision.
+static void reference(double temperature, double percentHumidity,
+                      double* dewPoint, double* absoluteHumidity,
+                      double* vaporPressureDeficit) {
+  double gamma = 17.62 * temperature / (243.12 + temperature);
+  double saturation = 6.112 * exp(gamma);
+  double rh = percentHumidity / 100;
+  double vapour = saturation * rh;
+  gamma += log(rh);
+  *dewPoint = 243.12 * gamma / (17.62 - gamma);
+  *absoluteHumidity = 216.7 * vapour / (temperature + 273.15);
+  *vaporPressureDeficit = (saturation - vapour) / 10;
+}
+
+// Sweep -40..80 C and 1..100 %RH in steps of 0.1.
+static void testAccuracy(bool fast) {
+  double dewPoint = 0, absoluteHumidity = 0, vaporPressureDeficit = 0;
+  for (int t = -400; t <= 800; t++) {
+    for (int h = 10; h <= 1000; h++) {
+      float temperature = t / 10.0F, humidity = h / 10.0F;
+      dht_psychrometrics_t values;
+      DHT_Psychrometrics::compute(temperature, humidity, &values, fast);
+      double d, a, v;
+      reference(temperature, humidity, &d, &a, &v);
+      dewPoint = fmax(dewPoint, fabs(values.dewPoint - d));
+      absoluteHumidity =
+          fmax(absoluteHumidity, fabs(values.absoluteHumidity - a));
+      vaporPressureDeficit =
+          fmax(vaporPressureDeficit, fabs(values.vaporPressureDeficit - v));
+    }
+  }
+  printf("%s  max error %.6f C / %.6f g/m^3 / %.6f kPa\n",
+         fast ? "fast:" : "libm:", dewPoint, absoluteHumidity,
+         vaporPressureDeficit);
+  expect(dewPoint <= 0.0001, "dew point within 0.0001 C");
+  expect(absoluteHumidity <= 0.001, "absolute humidity within 0.001 g/m^3");
+  expect(vaporPressureDeficit <= 0.0001, "VPD within 0.0001 kPa");
+
+  dht_psychrometrics_t values;
+  DHT_Psychrometrics::compute(25, 0, &values, fast);
+  expect(isnan(values.dewPoint), "no dew point for dry air");
+  expect(values.absoluteHumidity == 0, "dry air holds no water");
+}
+
+// Values are derived once per frame: calls within the sensor's minimum
+// interval neither read the bus nor see a changed sensor, a forced read does.
+static void testCache() {
+  simReset();
+  DHT dht(SIM_DATA_PIN, DHT22);
+  DHT_Psychrometrics psychrometrics(dht);
+  dht.begin();
+
+  dht_psychrometrics_t first, values;
+  expect(psychrometrics.read(&first), "first read");
+  expect(simStats.responses == 1, "first read uses the bus");
+
+  simSensors[0].temperature = 30;
+  simAdvance(1000e3);
+  expect(psychrometrics.dewPoint() == first.dewPoint &&
+             psychrometrics.absoluteHumidity() == first.absoluteHumidity &&
+             psychrometrics.vaporPressureDeficit() ==
+                 first.vaporPressureDeficit &&
+             psychrometrics.read(&values) &&
+             values.dewPoint == first.dewPoint,
+         "calls within two seconds return the cached values");
+  expect(simStats.responses == 1, "cached calls do not use the bus");
+
+  expect(psychrometrics.read(&values, true), "forced read");
+  expect(simStats.responses == 2, "a forced read uses the bus");
+  dht_psychrometrics_t expected;
+  DHT_Psychrometrics::compute(30, simSensors[0].humidity, &expected);
+  expect(values.dewPoint == expected.dewPoint &&
+             values.vaporPressureDeficit == expected.vaporPressureDeficit,
+         "a forced read recomputes");
+
+  simSensors[0].type = 0;
+  simAdvance(2000e3);
+  expect(isnan(psychrometrics.dewPoint()), "a failed read gives NAN");
+  simSensors[0].type = DHT22;
+  simAdvance(2000e3);
+  expect(psychrometrics.dewPoint() == expected.dewPoint,
+         "values are derived again after a failed read");
+}
+
+/*!
+ *  @brief  Run the psychrometrics tests
+ *  @return 0 if all checks passed
+ */
+int main() {
+  testAccuracy(true);
+  testAccuracy(false);
+  testCache();
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
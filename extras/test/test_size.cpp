@@ -0,0 +1,37 @@
+/*!
+ *  @file test_size.cpp
+ *
+ *  Guards the object sizes of the Arduino classes against growing back.
+ *  The limits are the current x86-64 sizes, below those of the original
+ *  library (DHT 20, DHT_Unified 72 bytes).
+ */
+
+#include <stdio.h>
+
+#include "DHT_Adaptive.h"
+#include "DHT_U.h"
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+  if (!condition) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+/*!
+ *  @brief  Run the object size checks
+ *  @return 0 if all checks passed
+ */
+int main() {
+  printf("sizeof DHT %zu, DHT_Unified %zu, DHT_Adaptive %zu\n", sizeof(DHT),
+         sizeof(DHT_Unified), sizeof(DHT_Adaptive));
+  if (sizeof(void*) == 8) {
+    expect(sizeof(DHT) <= 16, "DHT fits in 16 bytes");
+    expect(sizeof(DHT_Unified) <= 64, "DHT_Unified fits in 64 bytes");
+    expect(sizeof(DHT_Adaptive) <= 16, "DHT_Adaptive fits in 16 bytes");
+  }
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures != 0;
+}
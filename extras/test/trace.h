@@ -0,0 +1,50 @@
+/*!
+ *  @file trace.h
+ *
+ *  Synthetic day-long indoor climate traces shared by the host tests and
+ *  benchmarks.
+ */
+
+#ifndef DHT_TEST_TRACE_H
+#define DHT_TEST_TRACE_H
+
+#include <math.h>
+#include <stdint.h>
+
+// Indoor climate s seconds into a day: a daily temperature swing, a 40 minute
+// heating cycle and a shower raising the humidity at 7:00.
+static inline void dayTrace(double s, double* temperature, double* humidity) {
+  double day = s / 86400;
+  *temperature = 21 + 1.5 * sin(2 * M_PI * (day - 0.3)) +
+                 0.4 * sin(2 * M_PI * s / 2400);
+  *humidity = 45 + 3 * sin(2 * M_PI * day);
+  double shower = fmod(s, 86400) - 7 * 3600;
+  if (shower > 0 && shower < 3600) {
+    *humidity += 25 * exp(-shower / 900) * (1 - exp(-shower / 120));
+  }
+}
+
+// Deterministic xorshift32 noise source.
+static inline uint32_t traceRandom(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+// Raw DHT22 frame of a reading, rounded to the sensor's 0.1 resolution.
+static inline void dht22Frame(double temperature, double humidity,
+                              uint8_t* frame) {
+  int h = (int)lround(humidity * 10);
+  int t = (int)lround(fabs(temperature) * 10);
+  if (temperature < 0) {
+    t |= 0x8000;
+  }
+  frame[0] = h >> 8;
+  frame[1] = h & 0xFF;
+  frame[2] = t >> 8;
+  frame[3] = t & 0xFF;
+  frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+}
+
+#endif